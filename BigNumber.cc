@@ -7,6 +7,7 @@
 #include <string>
 #include <memory>
 #include <stdexcept>
+#include <climits>
 
 using namespace std;
 
@@ -387,6 +388,8 @@ BigNumber operator/(const BigNumber &lhs, const BigNumber &rhs) {
     return counter;
 }
 
+// 测试，作为库引用时定义WHEEL_NO_MAIN
+#ifndef WHEEL_NO_MAIN
 int main() {
     // test constructor
     /*
@@ -446,4 +449,4 @@ int main() {
     res = BigNumber("896") - BigNumber("4567");
     cout << res << endl;*/
 }
-
+#endif
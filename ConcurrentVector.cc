@@ -0,0 +1,383 @@
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <iostream>
+
+using namespace std;
+
+/**
+ * 多生产者追加的Vector
+ *
+ * push_back/emplace_back通过一个原子下标领取位置，不需要加锁。
+ * 存储按段(segment)分配，第k段的大小为 FIRST_SEGMENT << k，
+ * 扩容只是追加新段，已有元素永远不会被搬移，引用和指针一直有效。
+ * 新段由领到该段第一个位置的生产者分配，落在同一段的其他生产者等它分配完，
+ * 而不是各自分配一份再丢掉。
+ * 每个位置带一个状态，构造完成后才对读者可见，所以读者可以
+ * 一边追加一边遍历：遍历只走到第一个尚未构造完成的位置为止。
+ * 构造抛异常的位置被标记为DEAD，遍历和析构都跳过它。
+**/
+template <typename T>
+class ConcurrentVector {
+    enum : unsigned char { EMPTY, READY, DEAD };
+
+    struct Slot {
+        std::atomic<unsigned char> state;
+        alignas(T) unsigned char storage[sizeof(T)];
+
+        T *get() {
+            return reinterpret_cast<T*>(storage);
+        }
+    };
+
+public:
+    class iterator;
+
+    ConcurrentVector() = default;
+    // the atomics and the segment table are not copyable
+    ConcurrentVector(const ConcurrentVector &) = delete;
+    ConcurrentVector &operator=(const ConcurrentVector &) = delete;
+    ~ConcurrentVector() noexcept;
+
+    // add elements, safe to call from any number of threads
+    T &push_back(const T&);
+    T &push_back(T&&);
+    template <class... Args> T &emplace_back(Args&&...);
+
+    // allocate the segments needed to hold n elements up front
+    void reserve(size_t n);
+
+    // number of slots claimed so far; a slot becomes readable once the
+    // push_back that claimed it has returned, slots whose push_back threw
+    // are still counted but skipped by iteration
+    size_t size() const {
+        return std::min(next.load(std::memory_order_acquire), MAX_SIZE);
+    }
+    size_t capacity() const;
+
+    // element access, n must refer to a push that completed without throwing
+    T& operator[](size_t n) {
+        return *slot(n).get();
+    }
+    const T& operator[](size_t n) const {
+        return *slot(n).get();
+    }
+
+    // iterator interface
+    iterator begin() const {
+        return iterator(this, 0, size());
+    }
+    iterator end() const {
+        return iterator();
+    }
+
+private:
+    static constexpr size_t FIRST_SHIFT = 3;
+    static constexpr size_t FIRST_SEGMENT = size_t(1) << FIRST_SHIFT;
+    static constexpr size_t MAX_SEGMENTS = 48;
+    static constexpr size_t MAX_SIZE = (FIRST_SEGMENT << MAX_SEGMENTS) - FIRST_SEGMENT;
+    static constexpr int MAX_SPIN = 1024;
+
+    static std::allocator<Slot> alloc;  // allocates the segments
+
+    static size_t segment_size(size_t k) {
+        return FIRST_SEGMENT << k;
+    }
+    // index -> (segment, offset): shift the index so that segment k
+    // covers [2^(k+FIRST_SHIFT), 2^(k+FIRST_SHIFT+1))
+    static size_t segment_of(size_t n) {
+        return 63 - __builtin_clzll(n + FIRST_SEGMENT) - FIRST_SHIFT;
+    }
+    static size_t offset_of(size_t n, size_t k) {
+        return n + FIRST_SEGMENT - segment_size(k);
+    }
+
+    Slot &slot(size_t n) const {
+        auto k = segment_of(n);
+        return segments[k].load(std::memory_order_acquire)[offset_of(n, k)];
+    }
+    unsigned char state(size_t n) const {
+        auto k = segment_of(n);
+        auto seg = segments[k].load(std::memory_order_acquire);
+        return seg ? seg[offset_of(n, k)].state.load(std::memory_order_acquire)
+                   : static_cast<unsigned char>(EMPTY);
+    }
+
+    Slot *allocate_segment(size_t k);   // allocate segment k if nobody did yet
+    Slot *wait_segment(size_t k);       // wait for segment k to be allocated
+    Slot *claim();                      // take the next free slot
+
+    // keep the hot counter away from the segment table
+    alignas(64) std::atomic<size_t> next{0};
+    alignas(64) mutable std::atomic<Slot*> segments[MAX_SEGMENTS] = {};
+};
+
+// definition for the static data member
+template <typename T> std::allocator<typename ConcurrentVector<T>::Slot> ConcurrentVector<T>::alloc;
+
+template <typename T>
+class ConcurrentVector<T>::iterator {
+public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = T*;
+    using reference = T&;
+
+    iterator() = default;
+    iterator(const ConcurrentVector *v, size_t i, size_t n) : vec(v), idx(i), limit(n) {
+        settle();
+    }
+
+    T &operator*() const {
+        return (*const_cast<ConcurrentVector*>(vec))[idx];
+    }
+    T *operator->() const {
+        return &**this;
+    }
+    iterator &operator++() {
+        ++idx;
+        settle();
+        return *this;
+    }
+    iterator operator++(int) {
+        auto ret = *this;
+        ++*this;
+        return ret;
+    }
+    bool operator==(const iterator &rhs) const {
+        return idx == rhs.idx;
+    }
+    bool operator!=(const iterator &rhs) const {
+        return idx != rhs.idx;
+    }
+
+private:
+    static constexpr size_t npos = static_cast<size_t>(-1);
+
+    // skip slots whose constructor threw, stop at the snapshot size
+    // or at the first element still being built
+    void settle() {
+        while (idx != npos) {
+            if (idx >= limit) {
+                idx = npos;
+                break;
+            }
+            auto st = vec->state(idx);
+            if (st == READY) {
+                break;
+            }
+            if (st == DEAD) {
+                ++idx;
+            } else {
+                idx = npos;
+            }
+        }
+    }
+
+    const ConcurrentVector *vec = nullptr;
+    size_t idx = npos;
+    size_t limit = 0;
+};
+
+template <typename T>
+inline
+ConcurrentVector<T>::~ConcurrentVector() noexcept {
+    for (size_t k = 0; k != MAX_SEGMENTS; ++k) {
+        auto seg = segments[k].load(std::memory_order_relaxed);
+        if (!seg) {
+            continue;
+        }
+        for (size_t i = 0; i != segment_size(k); ++i) {
+            if (seg[i].state.load(std::memory_order_relaxed) == READY) {
+                seg[i].get()->~T();
+            }
+        }
+        alloc.deallocate(seg, segment_size(k));
+    }
+}
+
+template <typename T>
+inline
+size_t ConcurrentVector<T>::capacity() const {
+    size_t total = 0;
+    for (size_t k = 0; k != MAX_SEGMENTS; ++k) {
+        if (!segments[k].load(std::memory_order_acquire)) {
+            break;
+        }
+        total += segment_size(k);
+    }
+    return total;
+}
+
+template <typename T>
+inline
+typename ConcurrentVector<T>::Slot *ConcurrentVector<T>::allocate_segment(size_t k) {
+    auto seg = segments[k].load(std::memory_order_acquire);
+    if (seg) {
+        return seg;
+    }
+    // reserve() may race with the producer that owns the segment;
+    // the loser gives its block back
+    auto fresh = alloc.allocate(segment_size(k));
+    for (size_t i = 0; i != segment_size(k); ++i) {
+        ::new (static_cast<void*>(&fresh[i].state)) std::atomic<unsigned char>(EMPTY);
+    }
+    if (segments[k].compare_exchange_strong(seg, fresh, std::memory_order_acq_rel,
+                                            std::memory_order_acquire)) {
+        return fresh;
+    }
+    alloc.deallocate(fresh, segment_size(k));
+    return seg;
+}
+
+template <typename T>
+inline
+typename ConcurrentVector<T>::Slot *ConcurrentVector<T>::wait_segment(size_t k) {
+    for (int i = 0; i != MAX_SPIN; ++i) {
+        auto seg = segments[k].load(std::memory_order_acquire);
+        if (seg) {
+            return seg;
+        }
+        std::this_thread::yield();
+    }
+    // the owner is descheduled or its allocation threw, don't wait forever
+    return allocate_segment(k);
+}
+
+template <typename T>
+inline
+void ConcurrentVector<T>::reserve(size_t n) {
+    if (n == 0) {
+        return;
+    }
+    if (n > MAX_SIZE) {
+        throw std::length_error("ConcurrentVector::reserve");
+    }
+    for (size_t k = 0; k <= segment_of(n - 1); ++k) {
+        allocate_segment(k);
+    }
+}
+
+template <typename T>
+inline
+typename ConcurrentVector<T>::Slot *ConcurrentVector<T>::claim() {
+    auto n = next.fetch_add(1, std::memory_order_relaxed);
+    if (n >= MAX_SIZE) {
+        throw std::length_error("ConcurrentVector::push_back");
+    }
+    auto k = segment_of(n);
+    auto off = offset_of(n, k);
+    try {
+        // only the producer that claims the first slot of a segment allocates it,
+        // the others wait for it instead of each allocating a copy
+        return &(off == 0 ? allocate_segment(k) : wait_segment(k))[off];
+    } catch (...) {
+        // index n is taken either way; mark it DEAD so readers step over it.
+        // That needs the segment, which wait_segment retries to allocate. If no
+        // segment can be allocated at all, slot n stays EMPTY and iteration
+        // stops there until some later push manages to allocate it
+        try {
+            wait_segment(k)[off].state.store(DEAD, std::memory_order_release);
+        } catch (...) {
+        }
+        throw;
+    }
+}
+
+template <typename T>
+inline
+T &ConcurrentVector<T>::push_back(const T& s) {
+    return emplace_back(s);
+}
+
+template <typename T>
+inline
+T &ConcurrentVector<T>::push_back(T&& s) {
+    return emplace_back(std::move(s));
+}
+
+template <typename T>
+template <class... Args>
+inline
+T &ConcurrentVector<T>::emplace_back(Args&&... args) {
+    auto p = claim();
+    try {
+        ::new (static_cast<void*>(p->storage)) T(std::forward<Args>(args)...);
+    } catch (...) {
+        // the index is already taken, let readers step over it
+        p->state.store(DEAD, std::memory_order_release);
+        throw;
+    }
+    // publish: readers that see READY also see the constructed element
+    p->state.store(READY, std::memory_order_release);
+    return *p->get();
+}
+
+template <typename T>
+ostream &operator<<(ostream &os, const ConcurrentVector<T> &vec) {
+    for (auto &c : vec) {
+        os << c << " ";
+    }
+    return os;
+}
+
+// 测试，作为库引用时定义WHEEL_NO_MAIN
+#ifndef WHEEL_NO_MAIN
+int main() {
+    ConcurrentVector<int> ivec;
+    int &first = ivec.push_back(0);
+    for (int i = 1; i != 100; ++i) {
+        ivec.push_back(i);
+    }
+    // still the same object after several segments were added
+    cout << (&first == &ivec[0]) << " " << ivec.size() << " " << ivec.capacity() << endl;
+
+    // a throwing constructor leaves a dead slot that iteration skips
+    ConcurrentVector<string> svec;
+    svec.push_back("a");
+    try {
+        svec.emplace_back(string("a"), 2);  // out_of_range
+    } catch (const std::exception &) {
+    }
+    svec.push_back("b");
+    for (auto &c : svec) {
+        cout << c << " ";
+    }
+    cout << svec.size() << endl;
+
+    // 16 producers, one reader iterating at the same time
+    ConcurrentVector<long> lvec;
+    const int producers = 16, per_thread = 100000;
+    vector<thread> threads;
+    for (int t = 0; t != producers; ++t) {
+        threads.emplace_back([&lvec, t] {
+            for (int i = 0; i != per_thread; ++i) {
+                lvec.emplace_back(long(t) * per_thread + i);
+            }
+        });
+    }
+    size_t seen = 0;
+    for (auto &c : lvec) {
+        (void)c;
+        ++seen;
+    }
+    for (auto &t : threads) {
+        t.join();
+    }
+
+    long sum = 0;
+    for (auto c : lvec) {
+        sum += c;
+    }
+    long n = long(producers) * per_thread;
+    cout << lvec.size() << " " << (sum == n * (n - 1) / 2) << " " << (seen <= lvec.size()) << endl;
+}
+#endif
@@ -1,5 +1,14 @@
 #include <iostream>
 #include <memory>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <new>
+#include <cassert>
+#include <cstdint>
+#include <thread>
+#include <utility>
+#include <vector>
 
 using namespace std;
 
@@ -51,72 +60,775 @@ int main() {
 
 template <typename T>
 class Counter;
+template <typename T>
+class WeakPointer;
+template <typename T>
+class AtomicSmartPointer;
 
 template <typename T>
 class SmartPointer {
+    friend class WeakPointer<T>;
+    friend class AtomicSmartPointer<T>;
+    template <typename U, typename... Args>
+    friend SmartPointer<U> make_smart(Args&&... args);
 public:
+    // 空指针不分配控制块
     SmartPointer() {
-        ptr_counter = new Counter<T>();
+        ptr_counter = nullptr;
     }
     SmartPointer(T* p) {
-        ptr_counter = new Counter<T>(p);
+        ptr_counter = p ? new Counter<T>(p) : nullptr;
     }
     SmartPointer(const SmartPointer &sp) {
         ptr_counter = sp.ptr_counter;
-        ++ptr_counter->cnt;
+        if (ptr_counter) {
+            ptr_counter->add_ref();
+        }
+    }
+    SmartPointer(SmartPointer &&sp) noexcept {
+        ptr_counter = sp.ptr_counter;
+        sp.ptr_counter = nullptr;
     }
     SmartPointer& operator=(const SmartPointer &sp) {
-        ++sp.ptr_counter->cnt;
-        --ptr_counter->cnt;
-        if (ptr_counter->cnt == 0) {
-            cout << "delete" << endl;
-            delete ptr_counter;
-            ptr_counter = nullptr;
+        // 先加后减，自赋值也安全
+        if (sp.ptr_counter) {
+            sp.ptr_counter->add_ref();
+        }
+        if (ptr_counter) {
+            ptr_counter->release();
         }
         ptr_counter = sp.ptr_counter;
         return *this;
     }
+    SmartPointer& operator=(SmartPointer &&sp) noexcept {
+        std::swap(ptr_counter, sp.ptr_counter);
+        return *this;
+    }
     T& operator*() const {
         return *(ptr_counter->ptr);
     }
     T* operator->() const {
         return ptr_counter->ptr;
     }
+    T* get() const {
+        return ptr_counter ? ptr_counter->ptr : nullptr;
+    }
+    explicit operator bool() const {
+        return ptr_counter != nullptr;
+    }
     int use_count() const {
-        return ptr_counter->cnt;
+        return ptr_counter ? ptr_counter->cnt.load(std::memory_order_relaxed) : 0;
     }
     ~SmartPointer() {
-        --ptr_counter->cnt;
-        if (ptr_counter->cnt == 0) {
-            delete ptr_counter;
+        if (ptr_counter) {
+            ptr_counter->release();
         }
     }
 
 private:
+    // 接管一个已经计过数的控制块。带上标签参数，
+    // 否则SmartPointer(nullptr)在T*和Counter<T>*之间有二义性
+    struct adopt_t {};
+    SmartPointer(adopt_t, Counter<T> *c) : ptr_counter(c) {}
+    static SmartPointer adopt(Counter<T> *c) {
+        return SmartPointer(adopt_t(), c);
+    }
+
     Counter<T> *ptr_counter;
 };
 
+/**
+ * 控制块的内存池：按16字节分档，每个线程一组空闲链表，分配和释放都不加锁。
+ * 在别的线程释放的块进入释放线程的链表。每档本地最多缓存MAX_FREE个，
+ * 多出来的按BATCH个一批交给全局仓库(depot)，本地链表空了再从仓库整批取回，
+ * 这样延迟回收线程释放的块也能回到请求线程手里。仓库满了才还给系统。
+**/
+class CounterPool {
+public:
+    static void *allocate(size_t n);
+    static void deallocate(void *p, size_t n);
+    // 把当前线程缓存的块整批交给仓库
+    static void flush();
+
+private:
+    static constexpr size_t ALIGN = 16;
+    static constexpr size_t CLASSES = 16;       // 最大256字节
+    static constexpr size_t MAX_FREE = 4096;
+    static constexpr size_t BATCH = 64;
+    static constexpr size_t MAX_DEPOT = 256;    // 每档最多缓存的批数
+
+    struct FreeNode {
+        FreeNode *next;
+        FreeNode *next_batch;   // 只在仓库里每批的第一块上有意义
+    };
+    // 平凡析构，线程退出时其他thread_local的析构函数里仍然可以访问
+    struct Cache {
+        FreeNode *head[CLASSES];
+        size_t count[CLASSES];
+        bool dead;
+    };
+    struct Cleaner {
+        ~Cleaner();
+    };
+    // 同样平凡析构，静态对象析构之后退出的线程还能把块交回来
+    struct Depot {
+        std::atomic_flag busy = ATOMIC_FLAG_INIT;
+        // 锁内修改；原子类型只是为了锁外能先看一眼有没有库存
+        std::atomic<FreeNode*> batches{nullptr};
+        size_t count = 0;
+    };
+
+    static size_t class_of(size_t n) {
+        return (n + ALIGN - 1) / ALIGN - 1;
+    }
+    static Cache *cache();
+    // 从本地链表头上摘下BATCH块交给仓库，调用前count[k] >= BATCH
+    static void spill(Cache *c, size_t k);
+    static FreeNode *take_batch(size_t k);
+
+    static thread_local Cache tls_cache;
+    static Depot depots[CLASSES];
+};
+
+thread_local CounterPool::Cache CounterPool::tls_cache;
+CounterPool::Depot CounterPool::depots[CLASSES];
+
+CounterPool::Cleaner::~Cleaner() {
+    for (size_t k = 0; k != CLASSES; ++k) {
+        while (tls_cache.count[k] >= BATCH) {
+            spill(&tls_cache, k);
+        }
+        while (auto node = tls_cache.head[k]) {
+            tls_cache.head[k] = node->next;
+            ::operator delete(node);
+        }
+        tls_cache.count[k] = 0;
+    }
+    tls_cache.dead = true;
+}
+
+CounterPool::Cache *CounterPool::cache() {
+    // 第一次使用时注册线程退出时的清理
+    static thread_local Cleaner cleaner;
+    (void)cleaner;
+    return tls_cache.dead ? nullptr : &tls_cache;
+}
+
+void CounterPool::spill(Cache *c, size_t k) {
+    FreeNode *first = c->head[k], *last = first;
+    for (size_t i = 1; i != BATCH; ++i) {
+        last = last->next;
+    }
+    c->head[k] = last->next;
+    c->count[k] -= BATCH;
+    last->next = nullptr;
+
+    Depot &d = depots[k];
+    while (d.busy.test_and_set(std::memory_order_acquire)) {
+        std::this_thread::yield();
+    }
+    bool kept = d.count < MAX_DEPOT;
+    if (kept) {
+        first->next_batch = d.batches.load(std::memory_order_relaxed);
+        d.batches.store(first, std::memory_order_relaxed);
+        ++d.count;
+    }
+    d.busy.clear(std::memory_order_release);
+    if (!kept) {
+        while (first) {
+            auto node = first;
+            first = first->next;
+            ::operator delete(node);
+        }
+    }
+}
+
+CounterPool::FreeNode *CounterPool::take_batch(size_t k) {
+    Depot &d = depots[k];
+    // 没有库存时不去抢锁
+    if (!d.batches.load(std::memory_order_relaxed)) {
+        return nullptr;
+    }
+    while (d.busy.test_and_set(std::memory_order_acquire)) {
+        std::this_thread::yield();
+    }
+    FreeNode *batch = d.batches.load(std::memory_order_relaxed);
+    if (batch) {
+        d.batches.store(batch->next_batch, std::memory_order_relaxed);
+        --d.count;
+    }
+    d.busy.clear(std::memory_order_release);
+    return batch;
+}
+
+void *CounterPool::allocate(size_t n) {
+    size_t k = class_of(n);
+    Cache *c;
+    if (k < CLASSES && (c = cache())) {
+        if (!c->head[k] && (c->head[k] = take_batch(k))) {
+            c->count[k] = BATCH;
+        }
+        if (FreeNode *node = c->head[k]) {
+            c->head[k] = node->next;
+            --c->count[k];
+            return node;
+        }
+    }
+    return ::operator new(k < CLASSES ? (k + 1) * ALIGN : n);
+}
+
+void CounterPool::deallocate(void *p, size_t n) {
+    size_t k = class_of(n);
+    Cache *c;
+    if (k < CLASSES && (c = cache())) {
+        if (c->count[k] >= MAX_FREE) {
+            spill(c, k);
+        }
+        auto node = static_cast<FreeNode*>(p);
+        node->next = c->head[k];
+        c->head[k] = node;
+        ++c->count[k];
+        return;
+    }
+    ::operator delete(p);
+}
+
+void CounterPool::flush() {
+    Cache *c = cache();
+    if (!c) {
+        return;
+    }
+    for (size_t k = 0; k != CLASSES; ++k) {
+        while (c->count[k] >= BATCH) {
+            spill(c, k);
+        }
+    }
+}
+
+/**
+ * 延迟回收：打开后，最后一个强引用释放时不在当前线程析构对象，
+ * 而是放进队列，由后台线程成批析构并释放，大对象图的拆除不再占用请求线程。
+ * 关闭时(默认)行为和以前一样。
+**/
+class Reclaimer {
+public:
+    using Task = void (*)(void *);
+
+    static Reclaimer &instance() {
+        static Reclaimer r;
+        return r;
+    }
+    static void set_deferred(bool on) {
+        if (on) {
+            instance();
+        }
+        enabled.store(on, std::memory_order_release);
+    }
+    static bool deferred() {
+        return enabled.load(std::memory_order_relaxed);
+    }
+
+    void retire(void *obj, Task task);
+    // 等待队列里已有的对象全部回收完
+    void flush();
+
+private:
+    Reclaimer() : worker([this] { run(); }) {}
+    ~Reclaimer();
+    void run();
+
+    static std::atomic<bool> enabled;
+
+    std::mutex mtx;
+    std::condition_variable cv, idle;
+    std::vector<std::pair<void*, Task>> pending;
+    bool busy = false;
+    bool stop = false;
+    std::thread worker;
+};
+
+std::atomic<bool> Reclaimer::enabled{false};
+
+void Reclaimer::retire(void *obj, Task task) {
+    bool wake;
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        wake = pending.empty();
+        pending.emplace_back(obj, task);
+    }
+    // 队列非空时后台线程已经被叫醒过了
+    if (wake) {
+        cv.notify_one();
+    }
+}
+
+void Reclaimer::flush() {
+    std::unique_lock<std::mutex> lock(mtx);
+    idle.wait(lock, [this] { return pending.empty() && !busy; });
+}
+
+void Reclaimer::run() {
+    std::vector<std::pair<void*, Task>> batch;
+    std::unique_lock<std::mutex> lock(mtx);
+    while (true) {
+        cv.wait(lock, [this] { return stop || !pending.empty(); });
+        if (pending.empty()) {
+            break;
+        }
+        batch.swap(pending);
+        busy = true;
+        lock.unlock();
+        for (auto &item : batch) {
+            item.second(item.first);
+        }
+        batch.clear();
+        // 释放的块在本线程的缓存里，交给仓库让请求线程能再用上
+        CounterPool::flush();
+        lock.lock();
+        busy = false;
+        if (pending.empty()) {
+            idle.notify_all();
+        }
+    }
+}
+
+Reclaimer::~Reclaimer() {
+    // 之后释放的对象就地回收
+    enabled.store(false, std::memory_order_release);
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        stop = true;
+    }
+    cv.notify_one();
+    worker.join();
+}
+
+/**
+ * 控制块：强引用计数cnt和弱引用计数weak都是原子的。
+ * 所有强引用合起来持有一个弱引用，最后一个强引用销毁对象后再减掉它，
+ * weak归零时释放控制块本身。
+ * 加计数用relaxed；减计数用acq_rel，保证销毁前其他线程的写入都可见。
+ * 控制块的内存来自CounterPool。
+**/
 template <typename T>
 class Counter {
     friend class SmartPointer<T>;
+    friend class WeakPointer<T>;
+    friend class AtomicSmartPointer<T>;
 public:
     Counter() {
         ptr = nullptr;
-        cnt = 0;
     }
     Counter(T *p) {
         ptr = p;
-        cnt = 1;
     }
-    ~Counter() {
+    virtual ~Counter() {}
+
+    static void *operator new(size_t n) {
+        return CounterPool::allocate(n);
+    }
+    static void operator delete(void *p, size_t n) {
+        CounterPool::deallocate(p, n);
+    }
+    // 超对齐的对象不走内存池
+    static void *operator new(size_t n, std::align_val_t al) {
+        return ::operator new(n, al);
+    }
+    static void operator delete(void *p, size_t n, std::align_val_t al) {
+        ::operator delete(p, n, al);
+    }
+
+protected:
+    // 销毁对象
+    virtual void dispose() {
         delete ptr;
     }
-private:
+    // 释放控制块
+    virtual void destroy() {
+        delete this;
+    }
+
     T* ptr;
-    int cnt;
+
+private:
+    void add_ref() {
+        cnt.fetch_add(1, std::memory_order_relaxed);
+    }
+    void release() {
+        if (cnt.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            if (Reclaimer::deferred()) {
+                Reclaimer::instance().retire(this, reclaim);
+            } else {
+                reclaim(this);
+            }
+        }
+    }
+    static void reclaim(void *p) {
+        auto c = static_cast<Counter*>(p);
+        c->dispose();
+        c->weak_release();
+    }
+    void weak_add_ref() {
+        weak.fetch_add(1, std::memory_order_relaxed);
+    }
+    void weak_release() {
+        if (weak.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            destroy();
+        }
+    }
+    // 对象还活着时才加一个强引用
+    bool lock() {
+        int c = cnt.load(std::memory_order_relaxed);
+        while (c != 0) {
+            if (cnt.compare_exchange_weak(c, c + 1, std::memory_order_acq_rel,
+                                          std::memory_order_relaxed)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    std::atomic<int> cnt{1};
+    std::atomic<int> weak{1};
+};
+
+// make_smart用：对象和控制块在同一次分配里
+template <typename T>
+class InplaceCounter : public Counter<T> {
+public:
+    template <typename... Args>
+    InplaceCounter(Args&&... args) {
+        this->ptr = ::new (static_cast<void*>(storage)) T(std::forward<Args>(args)...);
+    }
+
+protected:
+    void dispose() override {
+        this->ptr->~T();
+    }
+
+private:
+    alignas(T) unsigned char storage[sizeof(T)];
+};
+
+template <typename T, typename... Args>
+SmartPointer<T> make_smart(Args&&... args) {
+    return SmartPointer<T>::adopt(new InplaceCounter<T>(std::forward<Args>(args)...));
+}
+
+template <typename T>
+class WeakPointer {
+public:
+    WeakPointer() = default;
+    WeakPointer(const SmartPointer<T> &sp) : ptr_counter(sp.ptr_counter) {
+        if (ptr_counter) {
+            ptr_counter->weak_add_ref();
+        }
+    }
+    WeakPointer(const WeakPointer &wp) : ptr_counter(wp.ptr_counter) {
+        if (ptr_counter) {
+            ptr_counter->weak_add_ref();
+        }
+    }
+    WeakPointer& operator=(const WeakPointer &wp) {
+        WeakPointer temp(wp);
+        std::swap(ptr_counter, temp.ptr_counter);
+        return *this;
+    }
+    ~WeakPointer() {
+        if (ptr_counter) {
+            ptr_counter->weak_release();
+        }
+    }
+
+    // 对象已经销毁时返回空的SmartPointer
+    SmartPointer<T> lock() const {
+        if (ptr_counter && ptr_counter->lock()) {
+            return SmartPointer<T>::adopt(ptr_counter);
+        }
+        return SmartPointer<T>();
+    }
+    bool expired() const {
+        return use_count() == 0;
+    }
+    int use_count() const {
+        return ptr_counter ? ptr_counter->cnt.load(std::memory_order_relaxed) : 0;
+    }
+
+private:
+    Counter<T> *ptr_counter = nullptr;
+};
+
+
+
+/**
+ * 侵入式引用计数：计数放在对象自己身上，不需要单独的Counter，
+ * 解引用只访问对象本身。
+ * 对象继承RefCounted<Policy>，或者为自己的类型特化IntrusiveTraits。
+ * AtomicRefCount可以跨线程共享，PlainRefCount只用于单线程，省掉原子操作。
+**/
+struct AtomicRefCount {
+    void inc() {
+        n.fetch_add(1, std::memory_order_relaxed);
+    }
+    // 减到0时返回true
+    bool dec() {
+        return n.fetch_sub(1, std::memory_order_acq_rel) == 1;
+    }
+    int get() const {
+        return n.load(std::memory_order_relaxed);
+    }
+    std::atomic<int> n{0};
+};
+
+struct PlainRefCount {
+    void inc() {
+        ++n;
+    }
+    bool dec() {
+        return --n == 0;
+    }
+    int get() const {
+        return n;
+    }
+    int n = 0;
+};
+
+template <typename Policy = AtomicRefCount>
+class RefCounted {
+public:
+    void add_ref() const {
+        refs.inc();
+    }
+    bool release() const {
+        return refs.dec();
+    }
+    int use_count() const {
+        return refs.get();
+    }
+
+protected:
+    RefCounted() = default;
+    // 拷贝对象不拷贝计数
+    RefCounted(const RefCounted &) {}
+    RefCounted &operator=(const RefCounted &) {
+        return *this;
+    }
+    ~RefCounted() = default;
+
+private:
+    mutable Policy refs;
 };
 
+template <typename T>
+struct IntrusiveTraits {
+    static void add_ref(const T *p) {
+        p->add_ref();
+    }
+    static void release(const T *p) {
+        if (p->release()) {
+            delete p;
+        }
+    }
+    static int use_count(const T *p) {
+        return p->use_count();
+    }
+};
 
+template <typename T, typename Traits = IntrusiveTraits<T>>
+class IntrusivePtr {
+public:
+    IntrusivePtr() = default;
+    IntrusivePtr(T* p) : ptr(p) {
+        if (ptr) {
+            Traits::add_ref(ptr);
+        }
+    }
+    IntrusivePtr(const IntrusivePtr &ip) : IntrusivePtr(ip.ptr) {}
+    IntrusivePtr(IntrusivePtr &&ip) noexcept : ptr(ip.ptr) {
+        ip.ptr = nullptr;
+    }
+    IntrusivePtr& operator=(const IntrusivePtr &ip) {
+        IntrusivePtr temp(ip);
+        std::swap(ptr, temp.ptr);
+        return *this;
+    }
+    IntrusivePtr& operator=(IntrusivePtr &&ip) noexcept {
+        std::swap(ptr, ip.ptr);
+        return *this;
+    }
+    T& operator*() const {
+        return *ptr;
+    }
+    T* operator->() const {
+        return ptr;
+    }
+    T* get() const {
+        return ptr;
+    }
+    explicit operator bool() const {
+        return ptr != nullptr;
+    }
+    int use_count() const {
+        return ptr ? Traits::use_count(ptr) : 0;
+    }
+    ~IntrusivePtr() {
+        if (ptr) {
+            Traits::release(ptr);
+        }
+    }
+
+private:
+    T* ptr = nullptr;
+};
+
+template <typename T, typename... Args>
+IntrusivePtr<T> make_intrusive(Args&&... args) {
+    return IntrusivePtr<T>(new T(std::forward<Args>(args)...));
+}
+
+
+
+/**
+ * 可以被多个线程同时读写的SmartPointer，读和换都不加锁。
+ *
+ * 分离计数(split reference count)：一个64位原子字的低48位存控制块指针，
+ * 高16位是"本地计数"。存进来的控制块预先加上BIAS个全局引用。
+ * load先给原子字的本地计数加一，此时控制块不会被释放；再给全局cnt加一
+ * 得到自己的引用，最后把本地计数还回去。
+ * 写者换掉旧值后，从旧控制块的cnt上减掉BIAS中没被本地计数占用的部分，
+ * 之后发现指针已经变了的读者改为直接释放一个全局引用。
+ * 在写者减掉之前，BIAS保证cnt不会因为这些读者提前归零。
+ * 读者从不等待写者；同时处于load中的线程不能超过65535个。
+ * 放在AtomicSmartPointer里的对象，use_count()会包含这部分BIAS。
+**/
+template <typename T>
+class AtomicSmartPointer {
+public:
+    AtomicSmartPointer() : AtomicSmartPointer(SmartPointer<T>()) {}
+    AtomicSmartPointer(const SmartPointer<T> &sp) : word(pack(acquire(sp))) {}
+    AtomicSmartPointer(const AtomicSmartPointer &) = delete;
+    AtomicSmartPointer& operator=(const AtomicSmartPointer &) = delete;
+    ~AtomicSmartPointer() {
+        retire(word.load(std::memory_order_acquire));
+    }
+
+    SmartPointer<T> load() const;
+    void store(const SmartPointer<T> &sp) {
+        exchange(sp);
+    }
+    SmartPointer<T> exchange(const SmartPointer<T> &sp) {
+        return retire(word.exchange(pack(acquire(sp)), std::memory_order_acq_rel));
+    }
+    // 控制块相同才替换；失败时expected更新为当前值
+    bool compare_exchange_strong(SmartPointer<T> &expected, const SmartPointer<T> &desired);
+    bool compare_exchange_weak(SmartPointer<T> &expected, const SmartPointer<T> &desired) {
+        return compare_exchange_strong(expected, desired);
+    }
+    bool is_lock_free() const {
+        return word.is_lock_free();
+    }
+
+private:
+    static_assert(sizeof(void*) == 8, "pointer and local count share one 64-bit word");
+    static constexpr int PTR_BITS = 48;
+    static constexpr uint64_t ONE = uint64_t(1) << PTR_BITS;
+    static constexpr uint64_t PTR_MASK = ONE - 1;
+    static constexpr int BIAS = 1 << 16;    // 大于本地计数的上限
+
+    static Counter<T> *ptr_of(uint64_t w) {
+        return reinterpret_cast<Counter<T>*>(w & PTR_MASK);
+    }
+    static uint64_t local_of(uint64_t w) {
+        return w >> PTR_BITS;
+    }
+    static uint64_t pack(Counter<T> *c) {
+        auto w = reinterpret_cast<uint64_t>(c);
+        assert((w & ~PTR_MASK) == 0);
+        return w;
+    }
+    // 原子字持有BIAS个引用
+    static Counter<T> *acquire(const SmartPointer<T> &sp) {
+        if (sp.ptr_counter) {
+            sp.ptr_counter->cnt.fetch_add(BIAS, std::memory_order_relaxed);
+        }
+        return sp.ptr_counter;
+    }
+    // 换下来的旧值：本地计数对应的引用留给那些读者去释放，
+    // 再留一个交给返回值，其余的减掉；返回值持有引用，cnt不会在这里归零
+    static SmartPointer<T> retire(uint64_t w) {
+        auto c = ptr_of(w);
+        if (!c) {
+            return SmartPointer<T>();
+        }
+        c->cnt.fetch_sub(BIAS - static_cast<int>(local_of(w)) - 1, std::memory_order_acq_rel);
+        return SmartPointer<T>::adopt(c);
+    }
+
+    mutable std::atomic<uint64_t> word;
+};
+
+template <typename T>
+SmartPointer<T> AtomicSmartPointer<T>::load() const {
+    uint64_t cur = word.fetch_add(ONE, std::memory_order_acquire) + ONE;
+    auto c = ptr_of(cur);
+    if (c) {
+        c->add_ref();
+    }
+    // 归还本地计数。指针变了、或者本地计数已经被别人还光，
+    // 说明写者已经把它折算进了全局计数，改为释放一个全局引用。
+    // 同一个控制块上的本地计数可以互相顶替，总数不会错。
+    while (true) {
+        if (ptr_of(cur) != c || local_of(cur) == 0) {
+            if (c) {
+                c->release();
+            }
+            break;
+        }
+        if (word.compare_exchange_weak(cur, cur - ONE, std::memory_order_release,
+                                       std::memory_order_relaxed)) {
+            break;
+        }
+    }
+    return c ? SmartPointer<T>::adopt(c) : SmartPointer<T>();
+}
+
+template <typename T>
+bool AtomicSmartPointer<T>::compare_exchange_strong(SmartPointer<T> &expected,
+                                                    const SmartPointer<T> &desired) {
+    uint64_t cur = word.load(std::memory_order_acquire);
+    while (ptr_of(cur) == expected.ptr_counter) {
+        // 本地计数变了也会失败，重试即可
+        auto c = acquire(desired);
+        if (word.compare_exchange_weak(cur, pack(c), std::memory_order_acq_rel,
+                                       std::memory_order_acquire)) {
+            retire(cur);
+            return true;
+        }
+        if (c) {
+            // desired自己还持有引用，不会归零
+            c->cnt.fetch_sub(BIAS, std::memory_order_relaxed);
+        }
+    }
+    expected = load();
+    return false;
+}
+
+
+
+// 测试，作为库引用时定义WHEEL_NO_MAIN
+#ifndef WHEEL_NO_MAIN
+// 单线程用的链表节点
+struct Node : RefCounted<PlainRefCount> {
+    Node(int x) : val(x) {}
+    int val;
+    IntrusivePtr<Node> next;
+};
+
+struct Config {
+    Config(int v) : version(v), values(16, v) {}
+    int version;
+    vector<int> values;
+};
 
 int main() {
     
@@ -140,6 +852,74 @@ int main() {
     cout << s.use_count() << " " << s1.use_count() << " " << s2.use_count() << endl;
     s1 = s2;
     cout << s.use_count() << " " << s1.use_count() << " " << s2.use_count() << endl;
-    
-}
 
+    // 跨线程共享，一次分配
+    auto shared = make_smart<vector<int>>(3, 7);
+    WeakPointer<vector<int>> weak = shared;
+    vector<thread> threads;
+    for (int t = 0; t != 8; ++t) {
+        threads.emplace_back([shared] {
+            for (int i = 0; i != 100000; ++i) {
+                SmartPointer<vector<int>> copy = shared;
+            }
+        });
+    }
+    for (auto &t : threads) {
+        t.join();
+    }
+    cout << shared.use_count() << " " << (*weak.lock())[2] << endl;
+    shared = SmartPointer<vector<int>>();
+    cout << weak.expired() << " " << (weak.lock() ? "alive" : "expired") << endl;
+
+    // 侵入式
+    IntrusivePtr<Node> head = make_intrusive<Node>(1);
+    head->next = make_intrusive<Node>(2);
+    IntrusivePtr<Node> second = head->next;
+    cout << head.use_count() << " " << second.use_count() << endl;
+    head = second;
+    cout << head.use_count() << " " << head->val << endl;
+
+    // 读多写少的配置：读者不停load，写者偶尔换一份新的
+    AtomicSmartPointer<Config> config(make_smart<Config>(0));
+    atomic<bool> done{false};
+    atomic<long> torn{0};
+    vector<thread> readers;
+    for (int t = 0; t != 8; ++t) {
+        readers.emplace_back([&] {
+            while (!done.load(memory_order_relaxed)) {
+                auto cfg = config.load();
+                if (cfg->values.back() != cfg->version) {
+                    ++torn;
+                }
+            }
+        });
+    }
+    for (int v = 1; v <= 1000; ++v) {
+        config.store(make_smart<Config>(v));
+    }
+    auto expected = config.load();
+    bool swapped = config.compare_exchange_strong(expected, make_smart<Config>(-1));
+    done = true;
+    for (auto &t : readers) {
+        t.join();
+    }
+    cout << config.is_lock_free() << " " << swapped << " " << config.load()->version
+         << " " << torn << endl;
+
+    // 空指针不分配；大对象图交给后台线程拆除
+    SmartPointer<int> empty(nullptr);
+    cout << empty.use_count() << " " << (empty.get() == nullptr) << endl;
+    Reclaimer::set_deferred(true);
+    {
+        auto graph = make_smart<vector<SmartPointer<vector<int>>>>();
+        for (int i = 0; i != 1000; ++i) {
+            graph->push_back(make_smart<vector<int>>(1000, i));
+        }
+        WeakPointer<vector<SmartPointer<vector<int>>>> wg = graph;
+        graph = SmartPointer<vector<SmartPointer<vector<int>>>>();
+        Reclaimer::instance().flush();
+        cout << wg.expired() << endl;
+    }
+    Reclaimer::set_deferred(false);
+}
+#endif
@@ -1,22 +1,559 @@
 #include <vector>
 #include <iostream>
+#include <cstring>
+#include <charconv>
+#include <algorithm>
+#include <functional>
+#include <type_traits>
+#include <memory>
+#include <utility>
+#include <stdexcept>
+#include <cstddef>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+#include <unordered_map>
 
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define STRING_SIMD 1
+#endif
+
+
+/**
+ * 查找/比较的底层实现，按CPU在启动时选择AVX2、SSE4.2或标量版本。
+ * 所有函数都带长度，不依赖'\0'。find/rfind返回相对h的下标，找不到返回-1。
+**/
+struct StringKernels {
+    const char *name;
+    size_t (*find)(const char *h, size_t n, const char *s, size_t m);
+    size_t (*rfind)(const char *h, size_t n, const char *s, size_t m);
+    size_t (*find_first_of)(const char *h, size_t n, const char *set, size_t k);
+    int (*compare)(const char *a, const char *b, size_t n);
+    bool (*equals_ignore_case)(const char *a, const char *b, size_t n);
+    size_t (*count)(const char *h, size_t n, char c);
+};
+
+static constexpr size_t NOT_FOUND = static_cast<size_t>(-1);
+
+// 标量版本，也用来处理向量版本剩下的尾部
+static inline bool match_inner(const char *p, const char *s, size_t m) {
+    // 首尾字符已经比较过
+    return m <= 2 || memcmp(p + 1, s + 1, m - 2) == 0;
+}
+
+size_t scalar_find(const char *h, size_t n, const char *s, size_t m) {
+    if (m == 0) {
+        return 0;
+    }
+    size_t i = 0;
+    while (i + m <= n) {
+        auto p = static_cast<const char*>(memchr(h + i, s[0], n - m + 1 - i));
+        if (!p) {
+            return NOT_FOUND;
+        }
+        i = p - h;
+        if (h[i + m - 1] == s[m - 1] && match_inner(p, s, m)) {
+            return i;
+        }
+        ++i;
+    }
+    return NOT_FOUND;
+}
+
+size_t scalar_rfind(const char *h, size_t n, const char *s, size_t m) {
+    if (m > n) {
+        return NOT_FOUND;
+    }
+    if (m == 0) {
+        return n;
+    }
+    for (size_t i = n - m + 1; i-- != 0; ) {
+        if (h[i] == s[0] && h[i + m - 1] == s[m - 1] && match_inner(h + i, s, m)) {
+            return i;
+        }
+    }
+    return NOT_FOUND;
+}
+
+size_t scalar_find_first_of(const char *h, size_t n, const char *set, size_t k) {
+    if (k == 1) {
+        auto p = static_cast<const char*>(memchr(h, set[0], n));
+        return p ? p - h : NOT_FOUND;
+    }
+    bool table[256] = {};
+    for (size_t i = 0; i != k; ++i) {
+        table[static_cast<unsigned char>(set[i])] = true;
+    }
+    for (size_t i = 0; i != n; ++i) {
+        if (table[static_cast<unsigned char>(h[i])]) {
+            return i;
+        }
+    }
+    return NOT_FOUND;
+}
+
+int scalar_compare(const char *a, const char *b, size_t n) {
+    return n ? memcmp(a, b, n) : 0;
+}
+
+static inline char ascii_lower(char c) {
+    return (c >= 'A' && c <= 'Z') ? c + ('a' - 'A') : c;
+}
+
+bool scalar_equals_ignore_case(const char *a, const char *b, size_t n) {
+    for (size_t i = 0; i != n; ++i) {
+        if (ascii_lower(a[i]) != ascii_lower(b[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+size_t scalar_count(const char *h, size_t n, char c) {
+    size_t ret = 0;
+    for (size_t i = 0; i != n; ++i) {
+        ret += h[i] == c;
+    }
+    return ret;
+}
+
+const StringKernels scalar_kernels = {
+    "scalar", scalar_find, scalar_rfind, scalar_find_first_of,
+    scalar_compare, scalar_equals_ignore_case, scalar_count
+};
+
+#ifdef STRING_SIMD
+// SSE4.2: 16字节一组。find/rfind先用首尾两个字符筛出候选位置再逐个确认，
+// find_first_of用pcmpestri一次比较16个字符和最多16个候选字符。
+__attribute__((target("sse4.2,popcnt")))
+size_t sse42_find(const char *h, size_t n, const char *s, size_t m) {
+    if (m == 0 || m > n) {
+        return m ? NOT_FOUND : 0;
+    }
+    const __m128i first = _mm_set1_epi8(s[0]),
+                  last = _mm_set1_epi8(s[m - 1]);
+    size_t i = 0;
+    while (i + m - 1 + 16 <= n) {
+        // 先用memchr跳到首字符；候选密集时逐块过滤，遇到没有候选的块再交回memchr
+        auto p = static_cast<const char*>(memchr(h + i, s[0], n - m + 1 - i));
+        if (!p) {
+            return NOT_FOUND;
+        }
+        i = p - h;
+        for (; i + m - 1 + 16 <= n; i += 16) {
+            __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(h + i)),
+                    b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(h + i + m - 1));
+            unsigned mask = _mm_movemask_epi8(_mm_cmpeq_epi8(a, first));
+            if (!mask) {
+                i += 16;
+                break;
+            }
+            mask &= _mm_movemask_epi8(_mm_cmpeq_epi8(b, last));
+            while (mask) {
+                size_t pos = i + __builtin_ctz(mask);
+                if (match_inner(h + pos, s, m)) {
+                    return pos;
+                }
+                mask &= mask - 1;
+            }
+        }
+    }
+    size_t rest = scalar_find(h + i, n - i, s, m);
+    return rest == NOT_FOUND ? NOT_FOUND : i + rest;
+}
+
+__attribute__((target("sse4.2,popcnt")))
+size_t sse42_rfind(const char *h, size_t n, const char *s, size_t m) {
+    if (m > n) {
+        return NOT_FOUND;
+    }
+    if (m == 0) {
+        return n;
+    }
+    const __m128i first = _mm_set1_epi8(s[0]),
+                  last = _mm_set1_epi8(s[m - 1]);
+    // 候选起点[0, end)，从后往前每次处理16个
+    size_t end = n - m + 1;
+    for (; end >= 16; end -= 16) {
+        size_t j = end - 16;
+        __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(h + j)),
+                b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(h + j + m - 1));
+        unsigned mask = _mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(a, first),
+                                                        _mm_cmpeq_epi8(b, last)));
+        while (mask) {
+            unsigned bit = 31 - __builtin_clz(mask);
+            if (match_inner(h + j + bit, s, m)) {
+                return j + bit;
+            }
+            mask &= ~(1u << bit);
+        }
+    }
+    return scalar_rfind(h, end + m - 1, s, m);
+}
+
+__attribute__((target("sse4.2,popcnt")))
+size_t sse42_find_first_of(const char *h, size_t n, const char *set, size_t k) {
+    if (k > 16 || k == 1) {
+        return scalar_find_first_of(h, n, set, k);
+    }
+    char buf[16] = {};
+    memcpy(buf, set, k);
+    const __m128i needles = _mm_loadu_si128(reinterpret_cast<const __m128i*>(buf));
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(h + i));
+        int idx = _mm_cmpestri(needles, static_cast<int>(k), a, 16,
+                               _SIDD_UBYTE_OPS | _SIDD_CMP_EQUAL_ANY | _SIDD_LEAST_SIGNIFICANT);
+        if (idx != 16) {
+            return i + idx;
+        }
+    }
+    size_t rest = scalar_find_first_of(h + i, n - i, set, k);
+    return rest == NOT_FOUND ? NOT_FOUND : i + rest;
+}
+
+__attribute__((target("sse4.2,popcnt")))
+int sse42_compare(const char *a, const char *b, size_t n) {
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i)),
+                y = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+        unsigned mask = _mm_movemask_epi8(_mm_cmpeq_epi8(x, y)) ^ 0xffffu;
+        if (mask) {
+            size_t k = i + __builtin_ctz(mask);
+            return static_cast<unsigned char>(a[k]) - static_cast<unsigned char>(b[k]);
+        }
+    }
+    return scalar_compare(a + i, b + i, n - i);
+}
+
+// 'A'..'Z'加上0x20，其余不变；>=0x80的字节按有符号比较是负数，不受影响
+__attribute__((target("sse4.2,popcnt")))
+static inline __m128i sse42_lower(__m128i v) {
+    __m128i upper = _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8('A' - 1)),
+                                  _mm_cmpgt_epi8(_mm_set1_epi8('Z' + 1), v));
+    return _mm_or_si128(v, _mm_and_si128(upper, _mm_set1_epi8(0x20)));
+}
+
+__attribute__((target("sse4.2,popcnt")))
+bool sse42_equals_ignore_case(const char *a, const char *b, size_t n) {
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m128i x = sse42_lower(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i))),
+                y = sse42_lower(_mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i)));
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(x, y)) != 0xffff) {
+            return false;
+        }
+    }
+    return scalar_equals_ignore_case(a + i, b + i, n - i);
+}
+
+__attribute__((target("sse4.2,popcnt")))
+size_t sse42_count(const char *h, size_t n, char c) {
+    const __m128i v = _mm_set1_epi8(c);
+    size_t ret = 0, i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(h + i));
+        ret += __builtin_popcount(_mm_movemask_epi8(_mm_cmpeq_epi8(a, v)));
+    }
+    return ret + scalar_count(h + i, n - i, c);
+}
+
+const StringKernels sse42_kernels = {
+    "sse4.2", sse42_find, sse42_rfind, sse42_find_first_of,
+    sse42_compare, sse42_equals_ignore_case, sse42_count
+};
+
+// AVX2: 同样的算法，32字节一组；find_first_of沿用pcmpestri
+__attribute__((target("avx2,popcnt")))
+size_t avx2_find(const char *h, size_t n, const char *s, size_t m) {
+    if (m == 0 || m > n) {
+        return m ? NOT_FOUND : 0;
+    }
+    const __m256i first = _mm256_set1_epi8(s[0]),
+                  last = _mm256_set1_epi8(s[m - 1]);
+    size_t i = 0;
+    while (i + m - 1 + 32 <= n) {
+        // 先用memchr跳到首字符；候选密集时逐块过滤，遇到没有候选的块再交回memchr
+        auto p = static_cast<const char*>(memchr(h + i, s[0], n - m + 1 - i));
+        if (!p) {
+            return NOT_FOUND;
+        }
+        i = p - h;
+        for (; i + m - 1 + 32 <= n; i += 32) {
+            __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(h + i)),
+                    b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(h + i + m - 1));
+            unsigned mask = _mm256_movemask_epi8(_mm256_cmpeq_epi8(a, first));
+            if (!mask) {
+                i += 32;
+                break;
+            }
+            mask &= _mm256_movemask_epi8(_mm256_cmpeq_epi8(b, last));
+            while (mask) {
+                size_t pos = i + __builtin_ctz(mask);
+                if (match_inner(h + pos, s, m)) {
+                    return pos;
+                }
+                mask &= mask - 1;
+            }
+        }
+    }
+    size_t rest = sse42_find(h + i, n - i, s, m);
+    return rest == NOT_FOUND ? NOT_FOUND : i + rest;
+}
+
+__attribute__((target("avx2,popcnt")))
+size_t avx2_rfind(const char *h, size_t n, const char *s, size_t m) {
+    if (m > n) {
+        return NOT_FOUND;
+    }
+    if (m == 0) {
+        return n;
+    }
+    const __m256i first = _mm256_set1_epi8(s[0]),
+                  last = _mm256_set1_epi8(s[m - 1]);
+    size_t end = n - m + 1;
+    for (; end >= 32; end -= 32) {
+        size_t j = end - 32;
+        __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(h + j)),
+                b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(h + j + m - 1));
+        unsigned mask = _mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi8(a, first),
+                                                              _mm256_cmpeq_epi8(b, last)));
+        while (mask) {
+            unsigned bit = 31 - __builtin_clz(mask);
+            if (match_inner(h + j + bit, s, m)) {
+                return j + bit;
+            }
+            mask &= ~(1u << bit);
+        }
+    }
+    return sse42_rfind(h, end + m - 1, s, m);
+}
+
+__attribute__((target("avx2,popcnt")))
+int avx2_compare(const char *a, const char *b, size_t n) {
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i)),
+                y = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+        unsigned mask = ~static_cast<unsigned>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(x, y)));
+        if (mask) {
+            size_t k = i + __builtin_ctz(mask);
+            return static_cast<unsigned char>(a[k]) - static_cast<unsigned char>(b[k]);
+        }
+    }
+    return sse42_compare(a + i, b + i, n - i);
+}
+
+__attribute__((target("avx2,popcnt")))
+static inline __m256i avx2_lower(__m256i v) {
+    __m256i upper = _mm256_and_si256(_mm256_cmpgt_epi8(v, _mm256_set1_epi8('A' - 1)),
+                                     _mm256_cmpgt_epi8(_mm256_set1_epi8('Z' + 1), v));
+    return _mm256_or_si256(v, _mm256_and_si256(upper, _mm256_set1_epi8(0x20)));
+}
+
+__attribute__((target("avx2,popcnt")))
+bool avx2_equals_ignore_case(const char *a, const char *b, size_t n) {
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        __m256i x = avx2_lower(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i))),
+                y = avx2_lower(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i)));
+        if (static_cast<unsigned>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(x, y))) != 0xffffffffu) {
+            return false;
+        }
+    }
+    return sse42_equals_ignore_case(a + i, b + i, n - i);
+}
+
+__attribute__((target("avx2,popcnt")))
+size_t avx2_count(const char *h, size_t n, char c) {
+    const __m256i v = _mm256_set1_epi8(c);
+    size_t ret = 0, i = 0;
+    for (; i + 32 <= n; i += 32) {
+        __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(h + i));
+        ret += __builtin_popcount(_mm256_movemask_epi8(_mm256_cmpeq_epi8(a, v)));
+    }
+    return ret + sse42_count(h + i, n - i, c);
+}
+
+const StringKernels avx2_kernels = {
+    "avx2", avx2_find, avx2_rfind, sse42_find_first_of,
+    avx2_compare, avx2_equals_ignore_case, avx2_count
+};
+#endif
+
+// 先用标量版本，静态初始化时再换成CPU支持的最快版本
+const StringKernels *string_kernels = &scalar_kernels;
+
+const StringKernels *select_string_kernels() {
+#ifdef STRING_SIMD
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return &avx2_kernels;
+    }
+    if (__builtin_cpu_supports("sse4.2")) {
+        return &sse42_kernels;
+    }
+#endif
+    return &scalar_kernels;
+}
+
+static const bool string_kernels_selected = (string_kernels = select_string_kernels(), true);
+
+
+/**
+ * 不持有内存的只读视图，substr/find/split都只返回视图，不拷贝。
+ * 视图的生命周期不能超过它指向的字符串。
+**/
+class StringView {
+public:
+    static constexpr size_t npos = static_cast<size_t>(-1);
+
+    StringView() = default;
+    StringView(const char *str) : ptr(str), len(strlen(str)) {}
+    StringView(const char *str, size_t n) : ptr(str), len(n) {}
+
+    const char *data() const {
+        return ptr;
+    }
+    size_t size() const {
+        return len;
+    }
+    bool empty() const {
+        return len == 0;
+    }
+    char operator[](size_t n) const {
+        return ptr[n];
+    }
+    const char *begin() const {
+        return ptr;
+    }
+    const char *end() const {
+        return ptr + len;
+    }
+
+    StringView substr(size_t pos, size_t n = npos) const {
+        if (pos > len) {
+            throw std::out_of_range("StringView::substr");
+        }
+        return StringView(ptr + pos, std::min(n, len - pos));
+    }
+    size_t find(char c, size_t pos = 0) const {
+        if (pos >= len) {
+            return npos;
+        }
+        auto p = static_cast<const char*>(memchr(ptr + pos, c, len - pos));
+        return p ? p - ptr : npos;
+    }
+    size_t find(StringView s, size_t pos = 0) const {
+        if (pos > len) {
+            return npos;
+        }
+        size_t ret = string_kernels->find(ptr + pos, len - pos, s.ptr, s.len);
+        return ret == npos ? npos : pos + ret;
+    }
+    // 最后一个起点不超过pos的匹配
+    size_t rfind(StringView s, size_t pos = npos) const {
+        if (s.len > len) {
+            return npos;
+        }
+        size_t n = std::min(pos, len - s.len) + s.len;
+        return string_kernels->rfind(ptr, n, s.ptr, s.len);
+    }
+    size_t rfind(char c, size_t pos = npos) const {
+        return rfind(StringView(&c, 1), pos);
+    }
+    size_t find_first_of(StringView set, size_t pos = 0) const {
+        if (pos >= len || set.len == 0) {
+            return npos;
+        }
+        size_t ret = string_kernels->find_first_of(ptr + pos, len - pos, set.ptr, set.len);
+        return ret == npos ? npos : pos + ret;
+    }
+    // 字典序，返回值的符号同memcmp
+    int compare(StringView s) const {
+        int r = string_kernels->compare(ptr, s.ptr, std::min(len, s.len));
+        if (r != 0) {
+            return r;
+        }
+        return len < s.len ? -1 : (len > s.len ? 1 : 0);
+    }
+    // 只折叠ASCII字母
+    bool equals_ignore_case(StringView s) const {
+        return len == s.len && string_kernels->equals_ignore_case(ptr, s.ptr, len);
+    }
+    size_t count(char c) const {
+        return string_kernels->count(ptr, len, c);
+    }
+    // 不重叠的出现次数
+    size_t count(StringView s) const {
+        if (s.len == 0) {
+            return 0;
+        }
+        size_t ret = 0;
+        for (size_t pos = find(s); pos != npos; pos = find(s, pos + s.len)) {
+            ++ret;
+        }
+        return ret;
+    }
+    bool starts_with(StringView s) const {
+        return len >= s.len && string_kernels->compare(ptr, s.ptr, s.len) == 0;
+    }
+    bool ends_with(StringView s) const {
+        return len >= s.len && string_kernels->compare(ptr + len - s.len, s.ptr, s.len) == 0;
+    }
+    std::vector<StringView> split(char sep) const {
+        std::vector<StringView> ret;
+        size_t start = 0, pos;
+        while ((pos = find(sep, start)) != npos) {
+            ret.emplace_back(ptr + start, pos - start);
+            start = pos + 1;
+        }
+        ret.emplace_back(ptr + start, len - start);
+        return ret;
+    }
+
+    friend bool operator==(StringView lhs, StringView rhs) {
+        return lhs.len == rhs.len && string_kernels->compare(lhs.ptr, rhs.ptr, lhs.len) == 0;
+    }
+    friend bool operator!=(StringView lhs, StringView rhs) {
+        return !(lhs == rhs);
+    }
+
+private:
+    const char *ptr = "";
+    size_t len = 0;
+};
+
+std::ostream& operator<<(std::ostream &os, StringView s) {
+        os.write(s.data(), s.size());
+        return os;
+}
 
 class String {
 public:
     // constructor
-    String() : data(new char[1]) {
-        *data = '\0';
+    String() {
+        set_short_size(0);
     }
-    String(const char *str) : data(new char[strlen(str)+1]) {
-        strcpy(data, str);
+    String(const char *str) : String(str, strlen(str)) {}
+    String(const char *str, size_t n) {
+        init(str, n);
     }
+    explicit String(StringView sv) : String(sv.data(), sv.size()) {}
     /*
     String(const String &rhs) : data(new char[rhs.size()+1]) {
         strcpy(data, rhs.c_str());
     }*/
-    // delegate
-    String(const String &rhs) : String(rhs.data) {}
+    // 长度已知，不再strlen
+    String(const String &rhs) {
+        if (rhs.is_long()) {
+            init(rhs.rep.l.ptr, rhs.rep.l.size);
+        } else {
+            rep = rhs.rep;
+        }
+    }
 
     String& operator=(const String &rhs) {
         String temp(rhs);
@@ -25,38 +562,736 @@ public:
     }
 
     // 移动构造
-    String(String&& rhs) : data(rhs.data) {
-        rhs.data = nullptr;
+    String(String&& rhs) noexcept : rep(rhs.rep) {
+        rhs.set_short_size(0);
     }
-    String &operator=(String&& rhs) {
+    String &operator=(String&& rhs) noexcept {
         swap(rhs);
         return *this;
     }
 
     ~String() {
-        delete[] data;
+        if (is_long()) {
+            delete[] rep.l.ptr;
+        }
     }
 
     friend std::ostream& operator<<(std::ostream &os, const String &s);
     size_t size() const {
-        return strlen(data);
+        return is_long() ? rep.l.size : rep.s.size;
+    }
+    size_t capacity() const {
+        return is_long() ? (rep.l.cap & ~LONG_FLAG) : SHORT_CAP;
     }
     const char* c_str() const {
-        return data;
+        return is_long() ? rep.l.ptr : rep.s.buf;
+    }
+    void swap(String& rhs) noexcept {
+        std::swap(rep, rhs.rep);
+    }
+
+    // 视图，不拷贝；不要对临时String取视图
+    operator StringView() const {
+        return StringView(c_str(), size());
+    }
+    StringView substr(size_t pos, size_t n = StringView::npos) const & {
+        return StringView(*this).substr(pos, n);
+    }
+    std::vector<StringView> split(char sep) const & {
+        return StringView(*this).split(sep);
+    }
+    // 临时String的视图在语句结束时就悬空了，直接禁止
+    StringView substr(size_t pos, size_t n = StringView::npos) const && = delete;
+    std::vector<StringView> split(char sep) const && = delete;
+
+    // 查找与比较，见StringKernels
+    size_t find(StringView s, size_t pos = 0) const {
+        return StringView(*this).find(s, pos);
+    }
+    size_t find(char c, size_t pos = 0) const {
+        return StringView(*this).find(c, pos);
+    }
+    size_t rfind(StringView s, size_t pos = StringView::npos) const {
+        return StringView(*this).rfind(s, pos);
+    }
+    size_t rfind(char c, size_t pos = StringView::npos) const {
+        return StringView(*this).rfind(c, pos);
+    }
+    size_t find_first_of(StringView set, size_t pos = 0) const {
+        return StringView(*this).find_first_of(set, pos);
+    }
+    int compare(StringView s) const {
+        return StringView(*this).compare(s);
+    }
+    bool equals_ignore_case(StringView s) const {
+        return StringView(*this).equals_ignore_case(s);
+    }
+    size_t count(char c) const {
+        return StringView(*this).count(c);
+    }
+    size_t count(StringView s) const {
+        return StringView(*this).count(s);
+    }
+    bool starts_with(StringView s) const {
+        return StringView(*this).starts_with(s);
+    }
+    bool ends_with(StringView s) const {
+        return StringView(*this).ends_with(s);
+    }
+
+    // 追加，容量不足时按两倍扩容
+    void reserve(size_t n) {
+        if (n > capacity()) {
+            reallocate(n);
+        }
+    }
+    String &append(const char *str, size_t n);
+    String &append(const char *str) {
+        return append(str, strlen(str));
+    }
+    String &append(const String &rhs) {
+        return append(rhs.c_str(), rhs.size());
+    }
+    String &append(StringView sv) {
+        return append(sv.data(), sv.size());
+    }
+    String &append(size_t n, char c) {
+        memset(prepare(n), c, n);
+        set_size(size()+n);
+        return *this;
+    }
+    void push_back(char c) {
+        *prepare(1) = c;
+        set_size(size()+1);
+    }
+    String &operator+=(const String &rhs) {
+        return append(rhs);
     }
-    void swap(String& rhs) {
-        std::swap(data, rhs.data);
+    String &operator+=(const char *str) {
+        return append(str);
+    }
+    String &operator+=(char c) {
+        push_back(c);
+        return *this;
     }
 
 private:
-    char *data;
+    friend class StringBuilder;
+
+    // 短字符串(<=22字节)直接存放在对象内部，不分配堆内存。
+    // 长字符串的cap最高位作为标记，小端下它正好落在s.size所在的字节上。
+    struct Long {
+        char *ptr;
+        size_t size;
+        size_t cap;
+    };
+    static constexpr size_t SHORT_CAP = sizeof(Long) - 2;
+    struct Short {
+        char buf[SHORT_CAP+1];
+        unsigned char size;
+    };
+    static_assert(sizeof(Short) == sizeof(Long), "short and long layouts must overlap");
+    static_assert(__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__, "long flag lives in the last byte");
+    static constexpr size_t LONG_FLAG = size_t(1) << (sizeof(size_t)*8 - 1);
+
+    bool is_long() const {
+        return rep.s.size & 0x80;
+    }
+    void set_short_size(size_t n) {
+        rep.s.size = static_cast<unsigned char>(n);
+        rep.s.buf[n] = '\0';
+    }
+    void init(const char *str, size_t n) {
+        if (n <= SHORT_CAP) {
+            memcpy(rep.s.buf, str, n);
+            set_short_size(n);
+        } else {
+            rep.l.ptr = new char[n+1];
+            memcpy(rep.l.ptr, str, n);
+            rep.l.ptr[n] = '\0';
+            rep.l.size = n;
+            rep.l.cap = n | LONG_FLAG;
+        }
+    }
+    char *data() {
+        return is_long() ? rep.l.ptr : rep.s.buf;
+    }
+    void set_size(size_t n) {
+        // n超过SHORT_CAP时必然是长字符串
+        if (n > SHORT_CAP || is_long()) {
+            rep.l.size = n;
+            rep.l.ptr[n] = '\0';
+        } else {
+            set_short_size(n);
+        }
+    }
+    char *reallocate(size_t new_cap);
+    char *prepare(size_t extra);
+
+    union Rep {
+        Long l;
+        Short s;
+    } rep;
 };
 
 std::ostream& operator<<(std::ostream &os, const String &s) {
-        os << s.data;
+        os.write(s.c_str(), s.size());
+        return os;
+}
+
+// 移到一块容量为new_cap的堆内存上，返回新缓冲区
+char *String::reallocate(size_t new_cap) {
+    size_t len = size();
+    char *buf = new char[new_cap+1];
+    memcpy(buf, c_str(), len+1);
+    if (is_long()) {
+        delete[] rep.l.ptr;
+    }
+    rep.l.ptr = buf;
+    rep.l.size = len;
+    rep.l.cap = new_cap | LONG_FLAG;
+    return buf;
+}
+
+// 保证末尾还能再放extra个字符，返回写入位置，不修改size
+char *String::prepare(size_t extra) {
+    size_t len = size(),
+           cap = capacity();
+    if (extra > cap - len) {
+        return reallocate(std::max(len + extra, 2 * cap)) + len;
+    }
+    return data() + len;
+}
+
+String &String::append(const char *str, size_t n) {
+    size_t len = size();
+    const char *old = c_str();
+    // 追加自身的一部分：扩容后旧指针失效，按偏移重新取
+    if (!std::less<const char*>()(str, old) && std::less<const char*>()(str, old + len)) {
+        size_t off = str - old;
+        char *dest = prepare(n);
+        memcpy(dest, c_str() + off, n);
+    } else {
+        memcpy(prepare(n), str, n);
+    }
+    set_size(len+n);
+    return *this;
+}
+
+String operator+(const String &lhs, const String &rhs) {
+    String ret;
+    ret.reserve(lhs.size() + rhs.size());
+    ret.append(lhs).append(rhs);
+    return ret;
+}
+String operator+(String &&lhs, const String &rhs) {
+    lhs.append(rhs);
+    return std::move(lhs);
+}
+String operator+(const String &lhs, const char *rhs) {
+    size_t n = strlen(rhs);
+    String ret;
+    ret.reserve(lhs.size() + n);
+    ret.append(lhs).append(rhs, n);
+    return ret;
+}
+String operator+(String &&lhs, const char *rhs) {
+    lhs.append(rhs);
+    return std::move(lhs);
+}
+String operator+(const String &lhs, char rhs) {
+    String ret;
+    ret.reserve(lhs.size() + 1);
+    ret.append(lhs).push_back(rhs);
+    return ret;
+}
+String operator+(String &&lhs, char rhs) {
+    lhs.push_back(rhs);
+    return std::move(lhs);
+}
+String operator+(const char *lhs, const String &rhs) {
+    size_t n = strlen(lhs);
+    String ret;
+    ret.reserve(n + rhs.size());
+    ret.append(lhs, n).append(rhs);
+    return ret;
+}
+
+/**
+ * 拼接日志、报文用：所有内容直接写进同一个String的缓冲区，
+ * 数字通过to_chars格式化到末尾，不产生临时对象。
+**/
+class StringBuilder {
+public:
+    StringBuilder() = default;
+    explicit StringBuilder(size_t n) {
+        buf.reserve(n);
+    }
+
+    StringBuilder &append(const char *str, size_t n) {
+        buf.append(str, n);
+        return *this;
+    }
+    StringBuilder &operator<<(const char *str) {
+        buf.append(str);
+        return *this;
+    }
+    StringBuilder &operator<<(const String &s) {
+        buf.append(s);
+        return *this;
+    }
+    StringBuilder &operator<<(StringView sv) {
+        buf.append(sv);
+        return *this;
+    }
+    StringBuilder &operator<<(char c) {
+        buf.push_back(c);
+        return *this;
+    }
+    StringBuilder &operator<<(bool b) {
+        return b ? append("true", 4) : append("false", 5);
+    }
+    template <typename T,
+              typename = typename std::enable_if<std::is_arithmetic<T>::value>::type>
+    StringBuilder &operator<<(T value) {
+        // MAX_NUMBER放不下的类型(比如__int128)加大缓冲区重试
+        for (size_t room = MAX_NUMBER; ; room *= 2) {
+            char *dest = buf.prepare(room);
+            auto res = std::to_chars(dest, dest + room, value);
+            if (res.ec == std::errc()) {
+                buf.set_size(res.ptr - buf.c_str());
+                return *this;
+            }
+        }
+    }
+
+    size_t size() const {
+        return buf.size();
+    }
+    void reserve(size_t n) {
+        buf.reserve(n);
+    }
+    void clear() {
+        buf.set_size(0);
+    }
+    const String &str() const {
+        return buf;
+    }
+    // 交出结果，builder回到空状态
+    String take() {
+        String ret(std::move(buf));
+        return ret;
+    }
+
+private:
+    // 足够放下64位整数或double的最短表示
+    static constexpr size_t MAX_NUMBER = 32;
+    String buf;
+};
+
+/**
+ * 大文档拼接用的Rope：AVL平衡的二叉树，叶子引用共享的String缓冲区的一段。
+ * 拼接、切片、按下标访问都是O(log n)，切片不拷贝字符，
+ * 需要连续内存时再用str()拍平成String。
+**/
+class Rope {
+    struct Node;
+    using NodePtr = std::shared_ptr<const Node>;
+
+    struct Node {
+        // 叶子
+        std::shared_ptr<const String> buf;
+        size_t off = 0;
+        // 内部节点
+        NodePtr left, right;
+        size_t len = 0;     // 子树中的字符总数
+        int height = 1;
+
+        bool is_leaf() const {
+            return !left;
+        }
+    };
+
+public:
+    Rope() = default;
+    Rope(String s) {
+        if (s.size()) {
+            size_t n = s.size();
+            root = leaf(std::make_shared<const String>(std::move(s)), 0, n);
+        }
+    }
+    Rope(StringView sv) : Rope(String(sv)) {}
+    Rope(const char *str) : Rope(String(str)) {}
+
+    size_t size() const {
+        return root ? root->len : 0;
+    }
+    bool empty() const {
+        return !root;
+    }
+    char operator[](size_t n) const;
+
+    Rope &append(const Rope &rhs) {
+        root = join(root, rhs.root);
+        return *this;
+    }
+    Rope &operator+=(const Rope &rhs) {
+        return append(rhs);
+    }
+    friend Rope operator+(const Rope &lhs, const Rope &rhs) {
+        return Rope(join(lhs.root, rhs.root));
+    }
+
+    Rope substr(size_t pos, size_t n = StringView::npos) const;
+    // 拍平
+    String str() const {
+        String ret;
+        ret.reserve(size());
+        flatten(root, ret);
+        return ret;
+    }
+
+    friend std::ostream& operator<<(std::ostream &os, const Rope &r);
+
+private:
+    // 小叶子拼接时直接合并，避免树里堆满碎片
+    static constexpr size_t MERGE_LEAF = 256;
+
+    explicit Rope(NodePtr n) : root(std::move(n)) {}
+
+    static int height(const NodePtr &n) {
+        return n ? n->height : 0;
+    }
+    static NodePtr leaf(std::shared_ptr<const String> buf, size_t off, size_t len);
+    static NodePtr node(NodePtr l, NodePtr r);
+    static NodePtr rotate_left(const NodePtr &n);
+    static NodePtr rotate_right(const NodePtr &n);
+    static NodePtr balance(NodePtr l, NodePtr r);
+    static NodePtr join(const NodePtr &l, const NodePtr &r);
+    static std::pair<NodePtr, NodePtr> split(const NodePtr &n, size_t pos);
+    static void flatten(const NodePtr &n, String &out);
+
+    NodePtr root;
+};
+
+Rope::NodePtr Rope::leaf(std::shared_ptr<const String> buf, size_t off, size_t len) {
+    auto n = std::make_shared<Node>();
+    n->buf = std::move(buf);
+    n->off = off;
+    n->len = len;
+    return n;
+}
+
+Rope::NodePtr Rope::node(NodePtr l, NodePtr r) {
+    auto n = std::make_shared<Node>();
+    n->len = l->len + r->len;
+    n->height = std::max(l->height, r->height) + 1;
+    n->left = std::move(l);
+    n->right = std::move(r);
+    return n;
+}
+
+Rope::NodePtr Rope::rotate_left(const NodePtr &n) {
+    return node(node(n->left, n->right->left), n->right->right);
+}
+
+Rope::NodePtr Rope::rotate_right(const NodePtr &n) {
+    return node(n->left->left, node(n->left->right, n->right));
+}
+
+// 以l、r为左右子树建节点，高度差为2时旋转
+Rope::NodePtr Rope::balance(NodePtr l, NodePtr r) {
+    if (height(l) > height(r) + 1) {
+        if (height(l->left) < height(l->right)) {
+            l = rotate_left(l);
+        }
+        return rotate_right(node(std::move(l), std::move(r)));
+    }
+    if (height(r) > height(l) + 1) {
+        if (height(r->right) < height(r->left)) {
+            r = rotate_right(r);
+        }
+        return rotate_left(node(std::move(l), std::move(r)));
+    }
+    return node(std::move(l), std::move(r));
+}
+
+// 沿较高一侧的边下降到高度相近处再挂上去，代价O(|hl-hr|)
+Rope::NodePtr Rope::join(const NodePtr &l, const NodePtr &r) {
+    if (!l) {
+        return r;
+    }
+    if (!r) {
+        return l;
+    }
+    if (l->is_leaf() && r->is_leaf() && l->len + r->len <= MERGE_LEAF) {
+        String s(l->buf->c_str() + l->off, l->len);
+        s.append(r->buf->c_str() + r->off, r->len);
+        return leaf(std::make_shared<const String>(std::move(s)), 0, l->len + r->len);
+    }
+    if (l->height > r->height + 1) {
+        return balance(l->left, join(l->right, r));
+    }
+    if (r->height > l->height + 1) {
+        return balance(join(l, r->left), r->right);
+    }
+    return node(l, r);
+}
+
+// 切成[0, pos)和[pos, len)两棵树，叶子只调整区间，不拷贝字符
+std::pair<Rope::NodePtr, Rope::NodePtr> Rope::split(const NodePtr &n, size_t pos) {
+    if (!n || pos == 0) {
+        return {nullptr, n};
+    }
+    if (pos >= n->len) {
+        return {n, nullptr};
+    }
+    if (n->is_leaf()) {
+        return {leaf(n->buf, n->off, pos), leaf(n->buf, n->off + pos, n->len - pos)};
+    }
+    size_t wl = n->left->len;
+    if (pos < wl) {
+        auto parts = split(n->left, pos);
+        return {parts.first, join(parts.second, n->right)};
+    }
+    auto parts = split(n->right, pos - wl);
+    return {join(n->left, parts.first), parts.second};
+}
+
+void Rope::flatten(const NodePtr &n, String &out) {
+    if (!n) {
+        return;
+    }
+    if (n->is_leaf()) {
+        out.append(n->buf->c_str() + n->off, n->len);
+        return;
+    }
+    flatten(n->left, out);
+    flatten(n->right, out);
+}
+
+char Rope::operator[](size_t n) const {
+    auto cur = root.get();
+    while (!cur->is_leaf()) {
+        if (n < cur->left->len) {
+            cur = cur->left.get();
+        } else {
+            n -= cur->left->len;
+            cur = cur->right.get();
+        }
+    }
+    return (*cur->buf).c_str()[cur->off + n];
+}
+
+Rope Rope::substr(size_t pos, size_t n) const {
+    if (pos > size()) {
+        throw std::out_of_range("Rope::substr");
+    }
+    auto tail = split(root, pos).second;
+    return Rope(split(tail, std::min(n, size() - pos)).first);
+}
+
+std::ostream& operator<<(std::ostream &os, const Rope &r) {
+        // 按叶子顺序输出，不拍平
+        std::vector<const Rope::Node*> stack;
+        if (r.root) {
+            stack.push_back(r.root.get());
+        }
+        while (!stack.empty()) {
+            auto n = stack.back();
+            stack.pop_back();
+            if (n->is_leaf()) {
+                os.write(n->buf->c_str() + n->off, n->len);
+            } else {
+                stack.push_back(n->right.get());
+                stack.push_back(n->left.get());
+            }
+        }
+        return os;
+}
+
+/**
+ * 字符串驻留：内容相同的InternedString指向同一个条目，
+ * 比较和哈希只看指针，O(1)。条目在创建时算好哈希，之后只读，
+ * 从驻留池的分段内存里分配，程序结束前不释放。
+ * 驻留池按哈希高位分成若干分片，每片一把读写锁，已存在的字符串只需要读锁。
+**/
+class InternPool {
+public:
+    struct Entry {
+        size_t hash;
+        size_t len;
+        char data[1];
+    };
+
+    static InternPool &instance() {
+        static InternPool pool;
+        return pool;
+    }
+    static size_t hash(StringView sv) {
+        // FNV-1a
+        size_t h = 14695981039346656037ull;
+        for (char c : sv) {
+            h = (h ^ static_cast<unsigned char>(c)) * 1099511628211ull;
+        }
+        return h;
+    }
+    static const Entry *empty() {
+        static const Entry e = {hash(StringView()), 0, {'\0'}};
+        return &e;
+    }
+
+    const Entry *intern(StringView sv);
+    size_t size() const;
+
+private:
+    static constexpr size_t SHARD_BITS = 6;
+    static constexpr size_t SHARDS = size_t(1) << SHARD_BITS;
+    static constexpr size_t CHUNK = 64 * 1024;
+
+    struct Key {
+        size_t hash;
+        StringView sv;
+        bool operator==(const Key &rhs) const {
+            return hash == rhs.hash && sv == rhs.sv;
+        }
+    };
+    struct KeyHash {
+        size_t operator()(const Key &k) const {
+            return k.hash;
+        }
+    };
+    struct alignas(64) Shard {
+        mutable std::shared_mutex mtx;
+        std::unordered_map<Key, const Entry*, KeyHash> table;
+        // 条目从大块内存里顺序切出来，used是最后一块的用量
+        std::vector<std::unique_ptr<char[]>> chunks;
+        size_t used = CHUNK;
+        // 大字符串单独分配，不占chunks的位置
+        std::vector<std::unique_ptr<char[]>> large;
+
+        const Entry *make_entry(size_t h, StringView sv);
+    };
+
+    InternPool() = default;
+    Shard &shard(size_t h) {
+        // 用高位选分片，低位留给unordered_map选桶。
+        // FNV-1a末尾几个字节只影响到低48位左右，先把低位混到高位上，
+        // 否则只差最后几个字符的键会挤在少数几个分片里
+        h ^= h >> 32;
+        h *= 0x9E3779B97F4A7C15ull;
+        return shards[h >> (sizeof(size_t)*8 - SHARD_BITS)];
+    }
+
+    Shard shards[SHARDS];
+};
+
+const InternPool::Entry *InternPool::Shard::make_entry(size_t h, StringView sv) {
+    size_t bytes = offsetof(Entry, data) + sv.size() + 1;
+    bytes = (bytes + alignof(Entry) - 1) & ~(alignof(Entry) - 1);
+    char *mem;
+    if (bytes > CHUNK / 4) {
+        large.emplace_back(new char[bytes]);
+        mem = large.back().get();
+    } else {
+        if (used + bytes > CHUNK) {
+            chunks.emplace_back(new char[CHUNK]);
+            used = 0;
+        }
+        mem = chunks.back().get() + used;
+        used += bytes;
+    }
+    auto e = reinterpret_cast<Entry*>(mem);
+    e->hash = h;
+    e->len = sv.size();
+    memcpy(e->data, sv.data(), sv.size());
+    e->data[sv.size()] = '\0';
+    return e;
+}
+
+const InternPool::Entry *InternPool::intern(StringView sv) {
+    if (sv.empty()) {
+        return empty();
+    }
+    size_t h = hash(sv);
+    Shard &sh = shard(h);
+    {
+        std::shared_lock<std::shared_mutex> lock(sh.mtx);
+        auto it = sh.table.find(Key{h, sv});
+        if (it != sh.table.end()) {
+            return it->second;
+        }
+    }
+    std::unique_lock<std::shared_mutex> lock(sh.mtx);
+    // 加写锁期间可能已经被别的线程插入
+    auto it = sh.table.find(Key{h, sv});
+    if (it != sh.table.end()) {
+        return it->second;
+    }
+    auto e = sh.make_entry(h, sv);
+    sh.table.emplace(Key{h, StringView(e->data, e->len)}, e);
+    return e;
+}
+
+size_t InternPool::size() const {
+    size_t ret = 0;
+    for (auto &sh : shards) {
+        std::shared_lock<std::shared_mutex> lock(sh.mtx);
+        ret += sh.table.size();
+    }
+    return ret;
+}
+
+class InternedString {
+public:
+    InternedString() : entry(InternPool::empty()) {}
+    explicit InternedString(StringView sv) : entry(InternPool::instance().intern(sv)) {}
+    explicit InternedString(const String &s) : InternedString(StringView(s)) {}
+    explicit InternedString(const char *str) : InternedString(StringView(str)) {}
+
+    size_t size() const {
+        return entry->len;
+    }
+    const char *c_str() const {
+        return entry->data;
+    }
+    size_t hash() const {
+        return entry->hash;
+    }
+    operator StringView() const {
+        return StringView(entry->data, entry->len);
+    }
+    String str() const {
+        return String(entry->data, entry->len);
+    }
+
+    friend bool operator==(InternedString lhs, InternedString rhs) {
+        return lhs.entry == rhs.entry;
+    }
+    friend bool operator!=(InternedString lhs, InternedString rhs) {
+        return lhs.entry != rhs.entry;
+    }
+
+private:
+    const InternPool::Entry *entry;
+};
+
+std::ostream& operator<<(std::ostream &os, InternedString s) {
+        os.write(s.c_str(), s.size());
         return os;
 }
 
+namespace std {
+template <>
+struct hash<InternedString> {
+    size_t operator()(InternedString s) const {
+        return s.hash();
+    }
+};
+}
+
+// 测试，作为库引用时定义WHEEL_NO_MAIN
+#ifndef WHEEL_NO_MAIN
 // test
 // 函数形参
 void foo(String x) {}
@@ -88,7 +1323,80 @@ int main() {
     svec.push_back(s1);
     svec.push_back(baz());
     svec.push_back("good job");
+    svec.push_back("a string longer than twenty-two bytes");
+
+    // 追加
+    String s5;
+    for (int i = 0; i != 10; ++i) {
+        s5 += "ab";
+    }
+    s5.append(s5);
+    String s6 = s1 + ", " + s4 + '!';
+    std::cout << s5 << " " << s5.size() << " " << s5.capacity() << std::endl;
+    std::cout << s6 << std::endl;
+
+    StringBuilder sb;
+    sb << "pid=" << 4242 << " load=" << 0.75 << " ok=" << true << ' ' << -17L;
+    std::cout << sb.str() << std::endl;
+    svec.push_back(sb.take());
+
+    // 视图与Rope
+    String line("GET /index.html HTTP/1.1");
+    for (auto part : line.split(' ')) {
+        std::cout << "[" << part << "]";
+    }
+    std::cout << " " << line.substr(4, 11) << " " << StringView(line).find("HTTP") << std::endl;
+
+    Rope doc;
+    for (int i = 0; i != 1000; ++i) {
+        doc += Rope(String().append(100, char('a' + i % 26)));
+    }
+    Rope mid = doc.substr(150, 100) + "|" + doc.substr(99950);
+    std::cout << doc.size() << " " << doc[150] << doc[99999] << " " << mid.str().size()
+              << " " << mid.substr(95, 10) << std::endl;
+
+    // 查找与比较
+    String log("2020-05-01 ERROR disk full; 2020-05-01 WARN retry; 2020-05-02 ERROR disk full");
+    std::cout << string_kernels->name << " " << log.find("ERROR") << " " << log.rfind("ERROR")
+              << " " << log.find_first_of(";!") << " " << log.count("disk") << " " << log.count('-')
+              << " " << log.starts_with("2020") << " " << String("Disk FULL").equals_ignore_case("disk full")
+              << " " << (s1.compare("help") < 0) << std::endl;
+
+    // 驻留
+    InternedString k1("user_id"), k2(String("user_") + "id"), k3(log.substr(11, 5));
+    std::vector<std::thread> workers;
+    std::vector<InternedString> tags(8);
+    for (int t = 0; t != 8; ++t) {
+        workers.emplace_back([&tags, t] {
+            tags[t] = InternedString(t % 2 ? "tag:even" : "tag:odd");
+        });
+    }
+    for (auto &w : workers) {
+        w.join();
+    }
+    std::unordered_map<InternedString, int> hits;
+    for (auto t : tags) {
+        ++hits[t];
+    }
+    std::cout << (k1 == k2) << " " << (k1 != k3) << " " << k3 << " " << hits.size()
+              << " " << hits[InternedString("tag:odd")] << " " << InternPool::instance().size() << std::endl;
+
+    // 大字符串夹在小字符串中间，两边的内存互不覆盖
+    String big;
+    big.append(20000, 'x');
+    std::vector<InternedString> small;
+    for (int i = 0; i != 256; ++i) {
+        small.emplace_back(String("key") + char('a' + i % 26) + char('a' + i / 26));
+    }
+    InternedString kbig(big);
+    for (int i = 0; i != 256; ++i) {
+        small.emplace_back(String("val") + char('a' + i % 26) + char('a' + i / 26));
+    }
+    std::cout << (StringView(kbig) == StringView(big)) << " "
+              << (small[0] == InternedString("keyaa")) << " " << (small[511] == InternedString("valvj")) << std::endl;
+
     for (auto c: svec) {
-        std::cout << c << std::endl;
+        std::cout << c << " " << c.size() << std::endl;
     }
-}
\ No newline at end of file
+}
+#endif
@@ -207,6 +207,8 @@ ostream &operator<<(ostream &os, Vector<T> &vec) {
     return os;
 }
 
+// 测试，作为库引用时定义WHEEL_NO_MAIN
+#ifndef WHEEL_NO_MAIN
 int main() {
     Vector<int> ivec;
     ivec = {1, 2, 3};
@@ -219,6 +221,4 @@ int main() {
     cout << ivec1 << endl;
     cout << ivec1.capacity() << endl;
 }
-
-
-
+#endif
@@ -0,0 +1,142 @@
+/**
+ * 基准测试框架：每个用例自动确定迭代次数，使单次采样不少于min_time，
+ * 重复SAMPLES次取中位数，结果以JSON输出，便于和上一次的结果对比。
+ *
+ * 用法：
+ *     Bench bench("string", argc, argv);
+ *     bench.run("copy", "wheel", 16, [&](size_t iters) { ... });
+ *     return bench.finish();
+ *
+ * 命令行参数：--json FILE 把结果写到文件(默认标准输出)，
+ *            --min-time MS 单次采样的最短时间，--filter STR 只跑名字包含STR的用例。
+**/
+#ifndef CPP_WHEEL_BENCH_H
+#define CPP_WHEEL_BENCH_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// 阻止编译器把被测代码优化掉
+template <typename T>
+inline void do_not_optimize(const T &value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+inline void clobber_memory() {
+    asm volatile("" : : : "memory");
+}
+
+class Bench {
+public:
+    Bench(const char *suite, int argc, char **argv) : suite(suite) {
+        for (int i = 1; i < argc; ++i) {
+            if (!strcmp(argv[i], "--json") && i + 1 < argc) {
+                json_path = argv[++i];
+            } else if (!strcmp(argv[i], "--min-time") && i + 1 < argc) {
+                min_time = atof(argv[++i]) / 1e3;
+            } else if (!strcmp(argv[i], "--filter") && i + 1 < argc) {
+                filter = argv[++i];
+            } else {
+                std::cerr << "usage: " << argv[0]
+                          << " [--json FILE] [--min-time MS] [--filter STR]" << std::endl;
+                std::exit(2);
+            }
+        }
+    }
+
+    // f(iters)执行iters次操作；threads只用于记录，多线程由f自己负责
+    template <typename F>
+    void run(const std::string &name, const std::string &impl, size_t param, F f,
+             size_t threads = 1) {
+        if (!filter.empty() && name.find(filter) == std::string::npos) {
+            return;
+        }
+        // 迭代次数翻倍，直到一次采样足够长
+        size_t iters = 1;
+        double elapsed = time(f, iters);
+        while (elapsed < min_time) {
+            size_t next = elapsed > 0 ? size_t(iters * min_time / elapsed * 1.2) : iters * 10;
+            iters = std::max(iters * 2, std::min(next, iters * 100));
+            elapsed = time(f, iters);
+        }
+        std::vector<double> samples;
+        for (int i = 0; i != SAMPLES; ++i) {
+            samples.push_back(time(f, iters) / iters * 1e9);
+        }
+        std::sort(samples.begin(), samples.end());
+        results.push_back({name, impl, param, threads, iters, samples[SAMPLES / 2],
+                           samples.front()});
+        std::cerr << suite << "/" << name << "/" << impl << "/" << param;
+        if (threads > 1) {
+            std::cerr << "/t" << threads;
+        }
+        std::cerr << ": " << samples[SAMPLES / 2] << " ns/op" << std::endl;
+    }
+
+    int finish() {
+        std::ostringstream os;
+        os << "{\n  \"suite\": \"" << suite << "\",\n  \"results\": [";
+        for (size_t i = 0; i != results.size(); ++i) {
+            auto &r = results[i];
+            os << (i ? ",\n" : "\n") << "    {\"name\": \"" << r.name << "\", \"impl\": \"" << r.impl
+               << "\", \"param\": " << r.param << ", \"threads\": " << r.threads
+               << ", \"iterations\": " << r.iters << ", \"ns_per_op\": " << r.median
+               << ", \"ns_per_op_min\": " << r.min << "}";
+        }
+        os << "\n  ]\n}\n";
+        if (json_path.empty()) {
+            std::cout << os.str();
+            return 0;
+        }
+        std::ofstream out(json_path);
+        out << os.str();
+        return out ? 0 : 1;
+    }
+
+private:
+    static constexpr int SAMPLES = 5;
+
+    struct Result {
+        std::string name, impl;
+        size_t param, threads, iters;
+        double median, min;
+    };
+
+    template <typename F>
+    static double time(F &f, size_t iters) {
+        auto start = std::chrono::steady_clock::now();
+        f(iters);
+        clobber_memory();
+        auto stop = std::chrono::steady_clock::now();
+        return std::chrono::duration<double>(stop - start).count();
+    }
+
+    std::string suite;
+    std::string json_path;
+    std::string filter;
+    double min_time = 0.05;
+    std::vector<Result> results;
+};
+
+// 多线程用例：n个线程同时执行body(iters)，返回后全部结束
+template <typename F>
+void run_threads(size_t n, size_t iters, F body) {
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t != n; ++t) {
+        threads.emplace_back([&body, iters] { body(iters); });
+    }
+    for (auto &t : threads) {
+        t.join();
+    }
+}
+
+#endif
@@ -0,0 +1,84 @@
+#define WHEEL_NO_MAIN
+#include "../BigNumber.cc"
+#include "bench.h"
+
+#include <charconv>
+#include <random>
+
+// 首位非0的d位十进制数
+static string random_digits(size_t d, mt19937 &rng) {
+    string s(d, '0');
+    for (auto &c : s) {
+        c = char('0' + rng() % 10);
+    }
+    s[0] = char('1' + rng() % 9);
+    return s;
+}
+
+int main(int argc, char **argv) {
+    Bench bench("bignumber", argc, argv);
+    mt19937 rng(42);
+
+    for (size_t d : {9, 18, 100, 1000}) {
+        string sa = random_digits(d, rng),
+               sb = random_digits(d, rng),
+               sc = random_digits(d > 2 ? d - 2 : 1, rng);
+        BigNumber a(sa), b(sb), c(sc);
+
+        bench.run("add", "wheel", d, [&](size_t n) {
+            for (size_t i = 0; i != n; ++i) {
+                do_not_optimize(a + b);
+            }
+        });
+        bench.run("mul", "wheel", d, [&](size_t n) {
+            for (size_t i = 0; i != n; ++i) {
+                do_not_optimize(a * b);
+            }
+        });
+        // 除法是反复相减，除数只比被除数少两位，商小于1000
+        bench.run("div", "wheel", d, [&](size_t n) {
+            for (size_t i = 0; i != n; ++i) {
+                do_not_optimize(a / c);
+            }
+        });
+        bench.run("parse", "wheel", d, [&](size_t n) {
+            for (size_t i = 0; i != n; ++i) {
+                do_not_optimize(BigNumber(sa));
+            }
+        });
+        bench.run("print", "wheel", d, [&](size_t n) {
+            ostringstream os;
+            for (size_t i = 0; i != n; ++i) {
+                os.str("");
+                os << a;
+                do_not_optimize(os);
+            }
+        });
+
+        // 标准库没有大整数，只在内建整数放得下时对比
+        if (d <= 18) {
+            unsigned long long x = stoull(sa), y = stoull(sb);
+            bench.run("add", "std", d, [&](size_t n) {
+                for (size_t i = 0; i != n; ++i) {
+                    do_not_optimize(x + y);
+                }
+            });
+            bench.run("parse", "std", d, [&](size_t n) {
+                for (size_t i = 0; i != n; ++i) {
+                    unsigned long long v;
+                    from_chars(sa.data(), sa.data() + sa.size(), v);
+                    do_not_optimize(v);
+                }
+            });
+            bench.run("print", "std", d, [&](size_t n) {
+                ostringstream os;
+                for (size_t i = 0; i != n; ++i) {
+                    os.str("");
+                    os << x;
+                    do_not_optimize(os);
+                }
+            });
+        }
+    }
+    return bench.finish();
+}
@@ -0,0 +1,47 @@
+#define WHEEL_NO_MAIN
+#include "../ConcurrentVector.cc"
+#include "bench.h"
+
+#include <mutex>
+#include <vector>
+
+// 对比对象：用一把锁保护的std::vector
+struct LockedVector {
+    void push_back(long x) {
+        std::lock_guard<std::mutex> lock(mtx);
+        v.push_back(x);
+    }
+    std::mutex mtx;
+    std::vector<long> v;
+};
+
+int main(int argc, char **argv) {
+    Bench bench("concurrent_vector", argc, argv);
+    size_t hw = std::max(1u, std::thread::hardware_concurrency());
+
+    for (size_t threads : {size_t(1), size_t(4), size_t(16)}) {
+        if (threads > 1 && threads > 2 * hw) {
+            continue;
+        }
+        // 每次迭代是一次追加，总数平分给各线程
+        bench.run("push", "wheel", threads, [&](size_t n) {
+            ConcurrentVector<long> v;
+            run_threads(threads, n / threads + 1, [&v](size_t k) {
+                for (size_t i = 0; i != k; ++i) {
+                    v.push_back(long(i));
+                }
+            });
+            do_not_optimize(v.size());
+        }, threads);
+        bench.run("push", "std", threads, [&](size_t n) {
+            LockedVector v;
+            run_threads(threads, n / threads + 1, [&v](size_t k) {
+                for (size_t i = 0; i != k; ++i) {
+                    v.push_back(long(i));
+                }
+            });
+            do_not_optimize(v.v.size());
+        }, threads);
+    }
+    return bench.finish();
+}
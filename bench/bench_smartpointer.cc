@@ -0,0 +1,59 @@
+#define WHEEL_NO_MAIN
+#include "../SmartPointer.cc"
+#include "bench.h"
+
+#include <memory>
+
+template <typename P>
+static void copy_destroy(const P &src, size_t n) {
+    for (size_t i = 0; i != n; ++i) {
+        P p(src);
+        do_not_optimize(p);
+    }
+}
+
+int main(int argc, char **argv) {
+    Bench bench("smartpointer", argc, argv);
+    size_t hw = std::max(1u, std::thread::hardware_concurrency());
+
+    bench.run("create", "wheel", 0, [&](size_t n) {
+        for (size_t i = 0; i != n; ++i) {
+            SmartPointer<long> p(new long(1));
+            do_not_optimize(p);
+        }
+    });
+    bench.run("create", "std", 0, [&](size_t n) {
+        for (size_t i = 0; i != n; ++i) {
+            std::shared_ptr<long> p(new long(1));
+            do_not_optimize(p);
+        }
+    });
+    bench.run("make", "wheel", 0, [&](size_t n) {
+        for (size_t i = 0; i != n; ++i) {
+            auto p = make_smart<long>(1);
+            do_not_optimize(p);
+        }
+    });
+    bench.run("make", "std", 0, [&](size_t n) {
+        for (size_t i = 0; i != n; ++i) {
+            auto p = std::make_shared<long>(1);
+            do_not_optimize(p);
+        }
+    });
+
+    // 所有线程复制、销毁同一个指针，计数在线程间争用
+    auto wp = make_smart<long>(1);
+    auto sp = std::make_shared<long>(1);
+    for (size_t threads : {size_t(1), size_t(4), size_t(16)}) {
+        if (threads > 1 && threads > 2 * hw) {
+            continue;
+        }
+        bench.run("copy_destroy", "wheel", threads, [&](size_t n) {
+            run_threads(threads, n / threads + 1, [&wp](size_t k) { copy_destroy(wp, k); });
+        }, threads);
+        bench.run("copy_destroy", "std", threads, [&](size_t n) {
+            run_threads(threads, n / threads + 1, [&sp](size_t k) { copy_destroy(sp, k); });
+        }, threads);
+    }
+    return bench.finish();
+}
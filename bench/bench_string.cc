@@ -0,0 +1,103 @@
+#define WHEEL_NO_MAIN
+#include "../String.cc"
+#include "bench.h"
+
+#include <string>
+
+static std::string make_text(size_t len) {
+    std::string s;
+    for (size_t i = 0; i != len; ++i) {
+        s += char('a' + i % 26);
+    }
+    return s;
+}
+
+template <typename S>
+static void construct(const char *text, size_t n) {
+    for (size_t i = 0; i != n; ++i) {
+        S s(text);
+        do_not_optimize(s);
+    }
+}
+
+template <typename S>
+static void copy_many(const S &src, size_t n) {
+    for (size_t i = 0; i != n; ++i) {
+        S s(src);
+        do_not_optimize(s);
+    }
+}
+
+template <typename S>
+static void size_many(const S &src, size_t n) {
+    for (size_t i = 0; i != n; ++i) {
+        do_not_optimize(&src);
+        do_not_optimize(src.size());
+    }
+}
+
+template <typename S>
+static void append(const char *piece, size_t count, size_t n) {
+    for (size_t i = 0; i != n; ++i) {
+        S s;
+        for (size_t k = 0; k != count; ++k) {
+            s += piece;
+        }
+        do_not_optimize(s);
+    }
+}
+
+int main(int argc, char **argv) {
+    Bench bench("string", argc, argv);
+
+    for (size_t len : {8, 22, 64, 4096}) {
+        std::string text = make_text(len);
+        String ws(text.c_str());
+        std::string ss(text);
+
+        bench.run("construct", "wheel", len, [&](size_t n) { construct<String>(text.c_str(), n); });
+        bench.run("construct", "std", len, [&](size_t n) { construct<std::string>(text.c_str(), n); });
+        bench.run("copy", "wheel", len, [&](size_t n) { copy_many(ws, n); });
+        bench.run("copy", "std", len, [&](size_t n) { copy_many(ss, n); });
+        bench.run("size", "wheel", len, [&](size_t n) { size_many(ws, n); });
+        bench.run("size", "std", len, [&](size_t n) { size_many(ss, n); });
+    }
+
+    for (size_t count : {16, 1024}) {
+        bench.run("append", "wheel", count, [&](size_t n) { append<String>("0123456789", count, n); });
+        bench.run("append", "std", count, [&](size_t n) { append<std::string>("0123456789", count, n); });
+    }
+
+    // 在长文本末尾查找
+    for (size_t len : {256, 65536}) {
+        std::string text = make_text(len) + "NEEDLE";
+        String ws(text.c_str());
+        bench.run("find", "wheel", len, [&](size_t n) {
+            for (size_t i = 0; i != n; ++i) {
+                do_not_optimize(ws.find("NEEDLE"));
+            }
+        });
+        bench.run("find", "std", len, [&](size_t n) {
+            for (size_t i = 0; i != n; ++i) {
+                do_not_optimize(text.find("NEEDLE"));
+            }
+        });
+    }
+    // 首字符到处都是，候选位置密集
+    for (size_t len : {256, 65536}) {
+        std::string text(len, 'a');
+        text += "aab";
+        String ws(text.c_str());
+        bench.run("find_dense", "wheel", len, [&](size_t n) {
+            for (size_t i = 0; i != n; ++i) {
+                do_not_optimize(ws.find("aab"));
+            }
+        });
+        bench.run("find_dense", "std", len, [&](size_t n) {
+            for (size_t i = 0; i != n; ++i) {
+                do_not_optimize(text.find("aab"));
+            }
+        });
+    }
+    return bench.finish();
+}
@@ -0,0 +1,59 @@
+#define WHEEL_NO_MAIN
+#include "../Vector.cc"
+#include "bench.h"
+
+#include <string>
+#include <vector>
+
+template <typename V>
+static void push_ints(size_t n, size_t count) {
+    for (size_t i = 0; i != n; ++i) {
+        V v;
+        for (size_t k = 0; k != count; ++k) {
+            v.push_back(int(k));
+        }
+        do_not_optimize(v);
+    }
+}
+
+// 元素需要搬移，测扩容时的移动开销
+template <typename V>
+static void grow_strings(size_t n, size_t count) {
+    for (size_t i = 0; i != n; ++i) {
+        V v;
+        for (size_t k = 0; k != count; ++k) {
+            v.emplace_back(40, 'x');
+        }
+        do_not_optimize(v);
+    }
+}
+
+template <typename V>
+static void copy_many(const V &src, size_t n) {
+    for (size_t i = 0; i != n; ++i) {
+        V v(src);
+        do_not_optimize(v);
+    }
+}
+
+int main(int argc, char **argv) {
+    Bench bench("vector", argc, argv);
+
+    for (size_t count : {16, 1024, 65536}) {
+        bench.run("push", "wheel", count, [&](size_t n) { push_ints<Vector<int>>(n, count); });
+        bench.run("push", "std", count, [&](size_t n) { push_ints<std::vector<int>>(n, count); });
+
+        bench.run("grow", "wheel", count, [&](size_t n) { grow_strings<Vector<std::string>>(n, count); });
+        bench.run("grow", "std", count, [&](size_t n) { grow_strings<std::vector<std::string>>(n, count); });
+
+        Vector<int> wv;
+        std::vector<int> sv;
+        for (size_t k = 0; k != count; ++k) {
+            wv.push_back(int(k));
+            sv.push_back(int(k));
+        }
+        bench.run("copy", "wheel", count, [&](size_t n) { copy_many(wv, n); });
+        bench.run("copy", "std", count, [&](size_t n) { copy_many(sv, n); });
+    }
+    return bench.finish();
+}